@@ -0,0 +1,178 @@
+// Binary translation pack, loadable at runtime with
+// `lv_i18n_load_pack_from_memory()`. Used in place (flash / mmap-ed file),
+// so all data are addressed by offsets from pack start. All numbers are
+// little-endian, and read byte-wise (no alignment requirements).
+//
+// header (32 bytes):
+//
+//   0  u32  magic "LVIP"
+//   4  u16  format version
+//   6  u16  flags (reserved, 0)
+//   8  u32  pack size
+//  12  u32  checksum, FNV-1a of bytes [16, size)
+//  16  u32  keys hash, must be equal to LV_I18N_KEYS_HASH of firmware
+//  20  u16  singular keys count
+//  22  u16  plural keys count
+//  24  u16  locales count (first one is base locale, for fallbacks)
+//  26  u16  reserved, 0
+//  28  u32  offset of locale records
+//
+// locale record (44 bytes):
+//
+//   0  u32  locale name (string offset)
+//   4  u32  singulars table offset (0 = none)
+//   8  u32  plurals table offsets [zero, one, two, few, many, other]
+//  32  u32  plural rule bytecode offset (0 = built-in rule)
+//  36  u16  plural rule bytecode size
+//  38  u8   built-in plural rule ID
+//  39  u8   reserved, 0
+//  40  u32  offset of this record, to find pack start from record pointer
+//
+// tables are u32 string offsets (0 = NULL), one per key. Then follows
+// deduplicated string pool, always ending with '\0'.
+//
+'use strict';
+
+
+const AppError = require('./app_error');
+const { fnv1a } = require('./hash');
+const { create_string_pool } = require('./string_pool');
+const { form_codes, create_plural_bytecode, eval_plural_bytecode } = require('./plurals');
+
+
+const MAGIC = 0x5049564C; // "LVIP"
+const VERSION = 2;
+const HEADER_SIZE = 32;
+const LOCALE_SIZE = 44;
+
+const forms = [ 'zero', 'one', 'two', 'few', 'many', 'other' ];
+
+// Rules, known by C runtime without bytecode. Must be in sync with
+// `__lv_i18n_plural_builtin()` in C.
+const builtin_rules = [
+  // 0: `other` only (ja, zh, ...)
+  () => form_codes.other,
+  // 1: `one` for 1 (en, de, ...)
+  n => (Math.abs(n) === 1 ? form_codes.one : form_codes.other)
+];
+
+const rule_samples = [ ...Array(1000).keys() ]
+  .concat([ 4, 5, 6, 7, 8, 9 ].map(p => 10 ** p).flatMap(v => [ v - 1, v, v + 1 ]));
+
+
+// Identifies set of keys, to make sure pack matches firmware
+function keys_hash(data) {
+  return fnv1a(data.singularKeys.map(k => k + '\0').join('') + '\x01' +
+               data.pluralKeys.map(k => k + '\0').join(''));
+}
+
+
+function find_builtin_rule(code) {
+  return builtin_rules.findIndex(rule => rule_samples.every(n => rule(n) === eval_plural_bytecode(code, n)));
+}
+
+
+function create_binary_pack(locales, data) {
+  if (data.singularKeys.length > 0xFFFF || data.pluralKeys.length > 0xFFFF || locales.length > 0xFFFF) {
+    throw new AppError('Too many keys or locales for binary pack (max 65535)');
+  }
+
+  let strings = [ ...locales ];
+
+  locales.forEach(l => {
+    data.singularKeys.forEach(k => strings.push(data[l].singular[k]));
+    Object.values(data[l].plural).forEach(form => data.pluralKeys.forEach(k => strings.push(form[k])));
+  });
+
+  const pool = create_string_pool(strings);
+
+  // Layout: header | locale records | rules | tables | pool
+  let rules = [];
+  let pos = HEADER_SIZE + locales.length * LOCALE_SIZE;
+
+  const records = locales.map(l => {
+    const code = create_plural_bytecode(l);
+    const builtin = find_builtin_rule(code);
+    const record = { name: l, code, builtin: Math.max(builtin, 0), rule: 0, tables: {} };
+
+    if (builtin < 0) {
+      if (code.length > 0xFFFF) throw new AppError(`Plural rule of ${l} is too big for binary pack`);
+      record.rule = pos;
+      rules.push(code);
+      pos += code.length;
+    }
+
+    return record;
+  });
+
+  // Align tables, for readability in hex dumps
+  pos = Math.ceil(pos / 4) * 4;
+
+  records.forEach(r => {
+    if (Object.keys(data[r.name].singular).length) {
+      r.tables.singular = pos;
+      pos += data.singularKeys.length * 4;
+    }
+
+    Object.keys(data[r.name].plural).forEach(form => {
+      r.tables[form] = pos;
+      pos += data.pluralKeys.length * 4;
+    });
+  });
+
+  const pool_start = pos;
+  const size = pool_start + pool.size;
+  const buf = Buffer.alloc(size);
+  const str = s => (s ? pool_start + pool.offset(s) : 0);
+
+  // Header
+  buf.writeUInt32LE(MAGIC, 0);
+  buf.writeUInt16LE(VERSION, 4);
+  buf.writeUInt16LE(0, 6);
+  buf.writeUInt32LE(size, 8);
+  buf.writeUInt32LE(keys_hash(data), 16);
+  buf.writeUInt16LE(data.singularKeys.length, 20);
+  buf.writeUInt16LE(data.pluralKeys.length, 22);
+  buf.writeUInt16LE(locales.length, 24);
+  buf.writeUInt32LE(HEADER_SIZE, 28);
+
+  // Locale records
+  records.forEach((r, i) => {
+    const base = HEADER_SIZE + i * LOCALE_SIZE;
+
+    buf.writeUInt32LE(str(r.name), base);
+    buf.writeUInt32LE(r.tables.singular || 0, base + 4);
+    forms.forEach((form, j) => buf.writeUInt32LE(r.tables[form] || 0, base + 8 + j * 4));
+    buf.writeUInt32LE(r.rule, base + 32);
+    buf.writeUInt16LE(r.rule ? r.code.length : 0, base + 36);
+    buf.writeUInt8(r.builtin, base + 38);
+    buf.writeUInt32LE(base, base + 40);
+  });
+
+  // Plural rules
+  Buffer.concat(rules).copy(buf, HEADER_SIZE + locales.length * LOCALE_SIZE);
+
+  // Tables
+  records.forEach(r => {
+    const singular = data[r.name].singular;
+
+    if (r.tables.singular) {
+      data.singularKeys.forEach((k, i) => buf.writeUInt32LE(str(singular[k]), r.tables.singular + i * 4));
+    }
+
+    Object.entries(data[r.name].plural).forEach(([ form, values ]) => {
+      data.pluralKeys.forEach((k, i) => buf.writeUInt32LE(str(values[k]), r.tables[form] + i * 4));
+    });
+  });
+
+  // String pool (first byte is '\0' already)
+  pool.entries.forEach(e => buf.write(e.str, pool_start + e.offset, 'utf8'));
+
+  buf.writeUInt32LE(fnv1a(buf.subarray(16)), 12);
+
+  return buf;
+}
+
+
+module.exports.keys_hash = keys_hash;
+module.exports.create_binary_pack = create_binary_pack;
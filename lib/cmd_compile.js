@@ -3,11 +3,22 @@
 
 
 const TranslationKeys = require('./translation_keys');
+const SourceKeys      = require('./source_keys');
 const AppError        = require('./app_error');
 const shell           = require('shelljs');
 
 const { join, dirname, basename, extname } = require('path');
-const { getRAW, getIDX }         = require('./compiler_template');
+const { getRAW, getIDX, getLocaleEnum, getKeysCount, getLocaleRAW, getSplitLocales,
+  getCppKeys, getScreens } = require('./compiler_template');
+const { create_string_pool }     = require('./string_pool');
+const { create_codebook, create_compressed_pool, decode } = require('./compress');
+const { create_format_tables }   = require('./format');
+const { create_binary_pack, keys_hash } = require('./binary_pack');
+const { create_manifest, is_up_to_date, save_manifest } = require('./manifest');
+const { create_glyphs }          = require('./glyphs');
+const { parse_profile, create_placement } = require('./profile');
+const { create_locale_diff }     = require('./locale_diff');
+const { prune_keys }             = require('./prune');
 
 const { readFileSync, writeFileSync }  = require('fs');
 
@@ -31,6 +42,33 @@ module.exports.subparserArgsList = [
       required: true
     }
   },
+  {
+    args:     [ '-s' ],
+    options: {
+      dest:     'sources',
+      help:     'source file(s) path (glob patterns allowed), to compile only phrases used there',
+      action:   'append',
+      metavar:  '<path>'
+    }
+  },
+  {
+    args:     [ '--sourceref' ],
+    options: {
+      dest:     'sourceref',
+      help:     'file from `extract --dump-sourceref`, to compile only phrases used in sources',
+      action:   'append',
+      metavar:  '<path>'
+    }
+  },
+  {
+    args:     [ '--screens' ],
+    options: {
+      dest:     'screens',
+      help:     'write phrase index lists of each source file, for batch lookup (needs -s or --sourceref)',
+      action:   'store_true',
+      default: false
+    }
+  },
   {
     args:     [ '-o' ],
     options: {
@@ -56,6 +94,129 @@ module.exports.subparserArgsList = [
       default: false
     }
   },
+  {
+    args:     [ '--linear-lookup' ],
+    options: {
+      dest:     'linear_lookup',
+      help:     'Search keys by linear scan instead of perfect hash (without --optimize only)',
+      action:   'store_true',
+      default: false
+    }
+  },
+  {
+    args:     [ '--resolve-fallback' ],
+    options: {
+      dest:     'resolve_fallback',
+      help:     'Bake base locale fallbacks into tables of other locales, to avoid double lookup',
+      action:   'store_true',
+      default: false
+    }
+  },
+  {
+    args:     [ '--string-pool' ],
+    options: {
+      dest:     'string_pool',
+      help:     'Store translations in single deduplicated blob, addressed by offsets instead of pointers',
+      action:   'store_true',
+      default: false
+    }
+  },
+  {
+    args:     [ '--compress' ],
+    options: {
+      dest:     'compress',
+      help:     'Compress string pool with byte pair encoding, strings are decoded on lookup (implies --string-pool)',
+      action:   'store_true',
+      default: false
+    }
+  },
+  {
+    args:     [ '--plural-table' ],
+    options: {
+      dest:     'plural_table',
+      help:     'Store plural rules as tables, evaluated by shared interpreter, instead of C functions',
+      action:   'store_true',
+      default: false
+    }
+  },
+  {
+    args:     [ '--format-tokens' ],
+    options: {
+      dest:     'format_tokens',
+      help:     'Pre-parse format strings for lv_i18n_format(), to not scan those in runtime',
+      action:   'store_true',
+      default: false
+    }
+  },
+  {
+    args:     [ '--string-info' ],
+    options: {
+      dest:     'string_info',
+      help:     'Add byte length, code point count & hash of each translation, for lv_i18n_get_singular_info()',
+      action:   'store_true',
+      default: false
+    }
+  },
+  {
+    args:     [ '--locale-diff' ],
+    options: {
+      dest:     'locale_diff',
+      help:     'Add bitmaps of phrases, changed between each pair of locales, for locale change callbacks',
+      action:   'store_true',
+      default: false
+    }
+  },
+  {
+    args:     [ '--binary' ],
+    options: {
+      dest:     'binary',
+      help:     'Write binary translations pack, for lv_i18n_load_pack_from_memory()',
+      metavar:  '<path>'
+    }
+  },
+  {
+    args:     [ '--glyphs' ],
+    options: {
+      dest:     'glyphs',
+      help:     'Write code points used by each locale (JSON), as ranges for `lv_font_conv --range`',
+      metavar:  '<path>'
+    }
+  },
+  {
+    args:     [ '--profile' ],
+    options: {
+      dest:     'profile',
+      help:     'Usage profile (lv_i18n_stats_dump() output or list of phrases), to place hot strings into ' +
+                'LV_I18N_HOT_SECTION and the rest into LV_I18N_COLD_SECTION',
+      metavar:  '<path>'
+    }
+  },
+  {
+    args:     [ '--split' ],
+    options: {
+      dest:     'split',
+      help:     'Write each locale to separate file (lv_i18n_<locale>.c), to link and register on demand',
+      action:   'store_true',
+      default: false
+    }
+  },
+  {
+    args:     [ '--cpp' ],
+    options: {
+      dest:     'cpp',
+      help:     'Also write lv_i18n.hpp, C++ front end with phrase IDs resolved at compile time',
+      action:   'store_true',
+      default: false
+    }
+  },
+  {
+    args:     [ '--manifest' ],
+    options: {
+      dest:     'manifest',
+      help:     'Record input & output hashes to file, and skip compile if nothing changed',
+      metavar:  '<path>'
+    }
+  },
   {
     args:     [ '-l' ],
     options: {
@@ -67,7 +228,155 @@ module.exports.subparserArgsList = [
 ];
 
 
+// Compare size of translation tables with pointers (assuming 32-bit MCU)
+// and with string pool.
+function print_pool_report(pool, strings) {
+  const offset_size = pool.offset_type === 'uint16_t' ? 2 : 4;
+  const strings_size = strings.filter(Boolean).reduce((acc, str) => acc + Buffer.byteLength(str) + 1, 0);
+  const pointers_total = strings.length * 4 + strings_size;
+  const pool_total = strings.length * offset_size + pool.size;
+
+  console.log(`Pointer tables: ${strings.length * 4} + strings: ${strings_size} = ${pointers_total} bytes`);
+  console.log(`Offset tables (${pool.offset_type}): ${strings.length * offset_size} + ` +
+    `string pool: ${pool.size} = ${pool_total} bytes ` +
+    `(${(100 * (pool_total - pointers_total) / (pointers_total || 1)).toFixed(1)}%)`);
+}
+
+
+// Phrase references `[ { key, plural, fileName } ]`, from sources and
+// source reference dumps
+function load_source_refs(args) {
+  let result = [];
+
+  if (args.sources) {
+    // Singular / plural conflicts are checked by `extract`
+    let sourceKeys = new SourceKeys({ conflicts: false });
+
+    sourceKeys.loadFiles(args.sources);
+
+    if (!sourceKeys.filesCount) throw new AppError('Failed to find any source file');
+
+    result.push(...sourceKeys.keys);
+  }
+
+  (args.sourceref || []).forEach(fileName => {
+    let refs;
+
+    try {
+      refs = JSON.parse(readFileSync(fileName, 'utf8'));
+    } catch (err) {
+      throw new AppError(`Failed to read source references "${fileName}": ${err.message}`);
+    }
+
+    if (!Array.isArray(refs) || refs.some(r => typeof r?.key !== 'string')) {
+      throw new AppError(`Bad source references "${fileName}", expected output of \`extract --dump-sourceref\``);
+    }
+
+    result.push(...refs);
+  });
+
+  return result;
+}
+
+
+// Phrases of each source file, in order of first use:
+// `[ { name, fileName, singular: [ key ], plural: [ key ] } ]`. Name is
+// file name without extension, as C identifier.
+function group_screens(refs) {
+  let screens = new Map();
+
+  refs.forEach(({ key, plural, fileName }) => {
+    if (!screens.has(fileName)) {
+      screens.set(fileName, { fileName, singular: [], plural: [] });
+    }
+
+    let list = screens.get(fileName)[plural ? 'plural' : 'singular'];
+
+    if (!list.includes(key)) list.push(key);
+  });
+
+  let names = {};
+
+  return Array.from(screens.values()).map(screen => {
+    let name = basename(screen.fileName, extname(screen.fileName)).replace(/[^A-Za-z0-9_]/g, '_');
+
+    if (names[name]) {
+      throw new AppError(`Source files "${names[name]}" and "${screen.fileName}" give the same screen name ` +
+        `"${name}", rename one of them`);
+    }
+    names[name] = screen.fileName;
+
+    return Object.assign({ name }, screen);
+  });
+}
+
+
+function print_prune_report(report, total) {
+  if (!report.keys.length) {
+    console.log(`Unused phrases: none of ${total}, nothing pruned`);
+    return;
+  }
+
+  console.log(`Unused phrases removed: ${report.keys.length} of ${total}`);
+  report.keys.forEach(k => console.log(`  "${k}"`));
+  // Locales without translations of removed phrases do not shrink
+  Object.entries(report.locales).filter(([ , { strings } ]) => strings).forEach(([ l, { strings, bytes } ]) => {
+    console.log(`  ${l}: ${strings} strings, ${bytes} bytes`);
+  });
+}
+
+
+// Hot phrases & size of hot / cold pools, for `--profile` option
+function print_placement_report(data, profile) {
+  const { hot, locales } = data.placement;
+  const size = kind => Object.values(locales).reduce((acc, pools) => acc + pools[kind].size, 0);
+  const found = hot.singular.size + hot.plural.size;
+
+  console.log(`Hot phrases: ${found} of ${data.singularKeys.length + data.pluralKeys.length}, ` +
+    `hot strings: ${size('hot')} bytes, cold strings: ${size('cold')} bytes`);
+
+  if (profile.skipped) console.log(`Profile: ${profile.skipped} truncated lines skipped`);
+}
+
+
+// Compare compressed pool(s) with plain one, and show decode cost (table
+// reads per string, ~ per output byte).
+function print_compress_report(codebook, pools, plain_size) {
+  const size = pools.reduce((acc, p) => acc + p.size, 0);
+  const steps = pools.flatMap(p => p.entries.map(e => decode(codebook.dict, e.bytes).steps));
+  const avg = steps.reduce((acc, n) => acc + n, 0) / (steps.length || 1);
+
+  const diff = (100 * (size + codebook.dict.length - plain_size) / (plain_size || 1)).toFixed(1);
+
+  console.log(`Compressed pool: ${size} + dictionary: ${codebook.dict.length} = ${size + codebook.dict.length} ` +
+    `bytes (${diff < 0 ? '' : '+'}${diff}% vs plain pool: ${plain_size} bytes)`);
+  console.log(`Decode on cache miss: ${avg.toFixed(1)} table reads per string on average, ` +
+    `${steps.reduce((acc, n) => Math.max(acc, n), 0)} max`);
+}
+
+
+// Write only if content differs, to keep mtime of unchanged outputs. Else
+// everything that includes `lv_i18n.h` is rebuilt on every compile.
+function write_if_changed(fileName, content) {
+  try {
+    if (readFileSync(fileName).equals(Buffer.from(content))) return;
+  } catch (__) {
+    // No file yet
+  }
+
+  writeFileSync(fileName, content);
+}
+
+
 module.exports.execute = function (args) {
+  let manifest = args.manifest ? create_manifest(args) : null;
+
+  if (manifest && is_up_to_date(args.manifest, manifest)) {
+    /*eslint-disable no-console*/
+    console.log('Translations not changed, skip compile');
+    return;
+  }
+
   let translationKeys = new TranslationKeys();
 
   translationKeys.loadFiles(args.translations);
@@ -105,8 +414,28 @@ You did not specified locale and we could not autodetect it. Use '-l' option.
     console.log(`Base locale '${args.base_locale}' (autodetected)`);
   }
 
-  if (!args.output && !args.output_raw) {
-    throw new AppError('You should specify output folder or raw output file option');
+  if (!args.output && !args.output_raw && !args.binary && !args.glyphs) {
+    throw new AppError('You should specify output folder or raw output file option (or binary pack, glyphs)');
+  }
+
+  if (args.split && !args.output) {
+    throw new AppError('--split option requires output folder (-o)');
+  }
+
+  if (args.profile && (args.string_pool || args.compress)) {
+    throw new AppError('--profile option can not be used with --string-pool or --compress');
+  }
+
+  if (args.screens && !args.sources && !args.sourceref) {
+    throw new AppError('--screens option requires source files (-s or --sourceref)');
+  }
+
+  if (args.screens && args.compress) {
+    throw new AppError('--screens option can not be used with --compress, which has no batch lookups');
+  }
+
+  if (args.cpp && !args.output && !args.output_raw) {
+    throw new AppError('--cpp option requires output folder (-o) or raw output file');
   }
 
   //
@@ -131,17 +460,15 @@ You did not specified locale and we could not autodetect it. Use '-l' option.
     data[l] = { singular: {}, plural: {} };
   });
 
+  let singularKeys = new Set();
+  let pluralKeys = new Set();
+
   translationKeys.phrases.forEach(p => {
-    if (p.value?.constructor !== Object) {
-      if (!data.singularKeys.includes(p.key)) {
-        data.singularKeys.push(p.key);
-      }
-    } else if (!data.pluralKeys.includes(p.key)) {
-      data.pluralKeys.push(p.key);
-    }
+    if (p.value?.constructor !== Object) singularKeys.add(p.key);
+    else pluralKeys.add(p.key);
   });
-  data.singularKeys.sort();
-  data.pluralKeys.sort();
+  data.singularKeys = Array.from(singularKeys).sort();
+  data.pluralKeys = Array.from(pluralKeys).sort();
 
   translationKeys.phrases.forEach(p => {
     if (p.value === null) return;
@@ -163,16 +490,158 @@ You did not specified locale and we could not autodetect it. Use '-l' option.
 
   });
 
+  let screens;
+
+  if (args.sources || args.sourceref) {
+    const total = data.singularKeys.length + data.pluralKeys.length;
+    const refs = load_source_refs(args);
+
+    print_prune_report(prune_keys(sorted_locales, data, new Set(refs.map(r => r.key))), total);
+
+    if (args.screens) screens = group_screens(refs);
+  }
+
+  //
+  // Resolve fallbacks at compile time. Missed singulars are taken from base
+  // locale. Plural forms differ between locales, so only mark plural keys
+  // without any translation, to switch lookup to base locale at once.
+  //
+  if (args.resolve_fallback) {
+    let base = data[args.base_locale];
+
+    sorted_locales.slice(1).forEach(l => {
+      data[l].singular = Object.assign({}, base.singular, data[l].singular);
+      data[l].pluralFallback = data.pluralKeys.map(k => !Object.values(data[l].plural).some(form => form[k]));
+    });
+  }
+
+  if (args.profile) {
+    let profile;
+
+    try {
+      profile = parse_profile(readFileSync(args.profile, 'utf8'));
+    } catch (err) {
+      throw new AppError(`Failed to read profile "${args.profile}": ${err.message}`);
+    }
+
+    data.placement = create_placement(sorted_locales, data, profile);
+    print_placement_report(data, profile);
+  }
+
+  // With `--split`, each locale file has own string pool & format tables
+  let locale_data = {};
+
+  sorted_locales.forEach(l => { locale_data[l] = Object.assign({}, data); });
+
+  let pool_offset_type;
+
+  if (args.compress) args.string_pool = true;
+
+  if (args.string_pool) {
+    const pool_strings = locales => {
+      let strings = [];
+
+      locales.forEach(l => {
+        if (Object.keys(data[l].singular).length) data.singularKeys.forEach(k => strings.push(data[l].singular[k]));
+        Object.values(data[l].plural).forEach(form => data.pluralKeys.forEach(k => strings.push(form[k])));
+      });
+
+      return strings;
+    };
+
+    const pool_groups = args.split ? sorted_locales.map(l => [ l ]) : [ sorted_locales ];
+    let pools = pool_groups.map(locales => create_string_pool(pool_strings(locales)));
+
+    // Codebook is trained on all locales, and is shared by split files
+    if (args.compress) {
+      const codebook = create_codebook(pool_strings(sorted_locales));
+      const packed = pool_groups.map(locales => create_compressed_pool(pool_strings(locales), codebook));
+      const plain_size = pools.reduce((acc, p) => acc + p.size, 0);
+
+      print_compress_report(codebook, packed, plain_size);
+
+      // Small or already dense texts do not pay for the dictionary
+      if (packed.reduce((acc, p) => acc + p.size, codebook.dict.length) >= plain_size) {
+        console.log('Compression does not reduce size, using plain string pool');
+        args.compress = false;
+      } else {
+        data.codebook = codebook;
+        pools = packed;
+
+        // Buffer for the longest decoded string
+        data.decode_size = pool_strings(sorted_locales).reduce((acc, str) =>
+          Math.max(acc, str ? Buffer.byteLength(str) + 1 : 1), 1);
+
+        console.log('Note: `_i()` caches and batch lookups are not available with --compress');
+      }
+    }
+
+    if (args.split) sorted_locales.forEach((l, i) => { locale_data[l].pool = pools[i]; });
+    else data.pool = pools[0];
+
+    pool_offset_type = pools.some(p => p.offset_type === 'uint32_t') ? 'uint32_t' : 'uint16_t';
+    print_pool_report({ offset_type: pool_offset_type, size: pools.reduce((acc, p) => acc + p.size, 0) },
+      pool_strings(sorted_locales));
+  }
+
+  if (args.format_tokens) {
+    if (args.split) {
+      sorted_locales.forEach(l => {
+        locale_data[l].formats = create_format_tables(sorted_locales, data, [ l ]);
+      });
+    } else {
+      data.formats = create_format_tables(sorted_locales, data);
+    }
+  }
+
+  if (args.locale_diff) data.diff = create_locale_diff(sorted_locales, data);
+
   let raw_idx;
   if (args.optimize) raw_idx = '#define LV_I18N_OPTIMIZE 1\n';
   else raw_idx = '#undef LV_I18N_OPTIMIZE\n';
-  raw_idx += getIDX(data);
+  if (args.linear_lookup) raw_idx += '#define LV_I18N_LINEAR_LOOKUP 1\n';
+  if (args.resolve_fallback) raw_idx += '#define LV_I18N_RESOLVED_FALLBACK 1\n';
+  if (args.string_pool) {
+    raw_idx += '#define LV_I18N_STRING_POOL 1\n';
+    raw_idx += `typedef ${pool_offset_type} lv_i18n_pool_offset_t;\n`;
+  }
+  if (args.compress) raw_idx += '#define LV_I18N_COMPRESS 1\n';
+  if (args.plural_table) raw_idx += '#define LV_I18N_PLURAL_TABLE 1\n';
+  if (args.format_tokens) raw_idx += '#define LV_I18N_FORMAT_TOKENS 1\n';
+  if (args.string_info) raw_idx += '#define LV_I18N_STRING_INFO 1\n';
+  if (args.locale_diff) raw_idx += '#define LV_I18N_LOCALE_DIFF 1\n';
+  if (args.binary) raw_idx += '#define LV_I18N_BINARY 1\n';
+  if (args.split) {
+    raw_idx += '#define LV_I18N_SPLIT 1\n';
+    raw_idx += getSplitLocales(sorted_locales);
+  }
+  if (args.binary || args.split) {
+    raw_idx += `#define LV_I18N_KEYS_HASH 0x${keys_hash(data).toString(16).padStart(8, '0')}u\n`;
+  }
+  raw_idx += getLocaleEnum(sorted_locales);
+  raw_idx += '\n' + getKeysCount(data);
+  if (args.optimize) raw_idx += '\n' + getIDX(data);
+  if (screens) raw_idx += '\n' + getScreens(data, screens);
   let raw = getRAW(args, sorted_locales, data);
+  let outputs = {};
+
+  if (args.binary) {
+    outputs[args.binary] = create_binary_pack(sorted_locales, data);
+  }
+
+  if (args.glyphs) {
+    outputs[args.glyphs] = JSON.stringify(create_glyphs(sorted_locales, data), null, 2) + '\n';
+  }
 
   if (args.output_raw) {
-    writeFileSync(args.output_raw, raw);
+    outputs[args.output_raw] = raw;
     let output_raw_header = join(dirname(args.output_raw), basename(args.output_raw, extname(args.output_raw)) + '.h');
-    writeFileSync(output_raw_header, raw_idx);
+    outputs[output_raw_header] = raw_idx;
+
+    if (args.cpp) {
+      outputs[join(dirname(args.output_raw), basename(args.output_raw, extname(args.output_raw)) + '.hpp')] =
+        getCppKeys(data);
+    }
   }
 
   if (args.output) {
@@ -184,7 +653,7 @@ You did not specified locale and we could not autodetect it. Use '-l' option.
     txt_h = txt_h.replace(/\/\*SAMPLE_START\*\/([\s\S]+)\/\*SAMPLE_END\*\//,
       `${raw_idx}
 ////////////////////////////////////////////////////////////////////////////////`);
-    writeFileSync(join(args.output, 'lv_i18n.h'), txt_h);
+    outputs[join(args.output, 'lv_i18n.h')] = txt_h;
 
     let txt = readFileSync(join(__dirname, '../src/lv_i18n.template.c'), 'utf-8');
 
@@ -192,6 +661,24 @@ You did not specified locale and we could not autodetect it. Use '-l' option.
       `${raw}
 ////////////////////////////////////////////////////////////////////////////////`);
 
-    writeFileSync(join(args.output, 'lv_i18n.c'), txt);
+    outputs[join(args.output, 'lv_i18n.c')] = txt;
+
+    if (args.cpp) {
+      let txt_hpp = readFileSync(join(__dirname, '../src/lv_i18n.template.hpp'), 'utf-8');
+
+      txt_hpp = txt_hpp.replace(/\/\*SAMPLE_START\*\/([\s\S]+)\/\*SAMPLE_END\*\//, getCppKeys(data).trim());
+      outputs[join(args.output, 'lv_i18n.hpp')] = txt_hpp;
+    }
+
+    if (args.split) {
+      sorted_locales.forEach(l => {
+        outputs[join(args.output, `lv_i18n_${l.toLowerCase().replace(/-/g, '_')}.c`)] =
+          getLocaleRAW(args, l, locale_data[l]);
+      });
+    }
   }
+
+  Object.entries(outputs).forEach(([ fileName, content ]) => write_if_changed(fileName, content));
+
+  if (manifest) save_manifest(args.manifest, manifest, outputs);
 };
@@ -57,6 +57,23 @@ module.exports.subparserArgsList = [
       default: false
     }
   },
+  {
+    args:     [ '--cache' ],
+    options: {
+      dest:         'cache',
+      help:         'cache parsed sources in file, to skip unchanged ones on next run',
+      metavar:  '<filename>'
+    }
+  },
+  {
+    args:     [ '-j', '--jobs' ],
+    options: {
+      dest:         'jobs',
+      help:         'max number of parallel parsers (default: CPU count)',
+      type:         'int',
+      metavar:  '<n>'
+    }
+  },
   {
     args:     [ '--dump-sourceref' ],
     options: {
@@ -73,7 +90,7 @@ module.exports.execute = function (args) {
   let sourceKeys = new SourceKeys();
   let translationKeys = new TranslationKeys();
 
-  sourceKeys.loadFiles(args.sources);
+  sourceKeys.loadFiles(args.sources, { cache: args.cache, jobs: args.jobs });
 
   if (!sourceKeys.filesCount) {
     throw new AppError ('Failed to find any source file');
@@ -65,14 +65,10 @@ module.exports.execute = function (args) {
 
   // Traverse locales
   Object.keys(translationKeys.localeDefaultFile).forEach(locale => {
-    let obj = translationKeys.getPhraseObj(locale, args.from);
-
     // If key found in this locale - drop destination entry & rename
-    if (obj) {
-      translationKeys.removePhraseObj(locale, args.to);
-      obj.key = args.to;
-      console.log(obj.fileName);
-    }
+    let obj = translationKeys.renamePhraseObj(locale, args.from, args.to);
+
+    if (obj) console.log(obj.fileName);
   });
 
   translationKeys.saveFiles();
@@ -1,7 +1,9 @@
 'use strict';
 
 
-const { create_c_plural_fn } = require('./plurals');
+const { create_c_plural_fn, create_plural_bytecode, eval_plural_bytecode } = require('./plurals');
+const { create_perfect_hash, create_literal_perfect_hash, fnv1a } = require('./hash');
+const AppError = require('./app_error');
 
 
 // en-GB => en_gb
@@ -9,6 +11,11 @@ function to_c(locale) {
   return locale.toLowerCase().replace(/-/g, '_');
 }
 
+// Locale name, as compared by `lv_i18n_set_locale()`: "en_GB" => "en-gb"
+function canonical(locale) {
+  return locale.toLowerCase().replace(/_/g, '-');
+}
+
 // escape C string to write all in one line.
 function esc(str) {
   // TODO: simple & dirty, should be improved.
@@ -37,7 +44,7 @@ const plural_helpers = `
 static inline uint32_t op_n(int32_t val) { return (uint32_t)(val < 0 ? -val : val); }
 static inline uint32_t op_i(uint32_t val) { return val; }
 // always zero, when decimal part not exists.
-static inline uint32_t op_v(uint32_t val) { UNUSED(val); return 0;}
+static inline uint32_t op_v(uint32_t val) { UNUSED(val); return 0; }
 static inline uint32_t op_w(uint32_t val) { UNUSED(val); return 0; }
 static inline uint32_t op_f(uint32_t val) { UNUSED(val); return 0; }
 static inline uint32_t op_t(uint32_t val) { UNUSED(val); return 0; }
@@ -45,20 +52,85 @@ static inline uint32_t op_e(uint32_t val) { UNUSED(val); return 0; }
 `.trim();
 
 
+// With `--string-pool`, tables contain offsets in pool instead of pointers
+function str_type(data) {
+  return data.pool ? 'lv_i18n_pool_offset_t' : 'char *';
+}
+
+// With `--profile`, pointers to hot / cold pool of locale `l`
+function str_entry(data, str, l) {
+  if (data.pool) return String(data.pool.offset(str));
+  if (!str) return 'NULL';
+  if (data.placement) {
+    const { hot, cold } = data.placement.locales[l];
+
+    return hot.offset(str) ? `${to_c(l)}_hot_strings + ${hot.offset(str)}` :
+      `${to_c(l)}_cold_strings + ${cold.offset(str)}`;
+  }
+  return '\"' + esc(str) + '\"';
+}
+
+
+// Encoded bytes as C string. Octal escapes are used, because hex ones
+// would eat following digits.
+function c_bytes(bytes) {
+  return Array.from(bytes, b => {
+    if (b >= 0x20 && b < 0x7F && b !== 0x22 && b !== 0x5C && b !== 0x3F) return String.fromCharCode(b);
+    return '\\' + b.toString(8).padStart(3, '0');
+  }).join('');
+}
+
+function string_pool_template(pool) {
+  const entry = e => (e.bytes ? `// "${esc(e.str)}"\n    /* ${e.offset} */ "${c_bytes(e.bytes)}\\0"` :
+    `/* ${e.offset} */ "${esc(e.str)}\\0"`);
+
+  return `
+static const char lv_i18n_string_pool[] =
+    /* 0 */ "\\0"${pool.entries.map(e => `\n    ${entry(e)}`).join('')};
+`.trim();
+}
+
+
+// Hot or cold strings of locale, for `--profile` mode
+function placement_pool_template(l, kind, pool) {
+  return `
+static const char ${to_c(l)}_${kind}_strings[] LV_I18N_${kind.toUpperCase()}_SECTION =
+    /* 0 */ "\\0"${pool.entries.map(e => `\n    /* ${e.offset} */ "${esc(e.str)}\\0"`).join('')};
+`.trim();
+}
+
+
+// Byte pair codebook for `--compress` mode, `{ 0, 0 }` for literal bytes
+function codebook_template(codebook, decode_size) {
+  const pairs = Array.from({ length: 256 }, (_, c) => `{ ${codebook.dict[c * 2]}, ${codebook.dict[c * 2 + 1]} }`);
+
+  // Buffer size is written here, not to header, so translation edits do
+  // not rebuild files, which include `lv_i18n.h`
+  return `
+// Longest decoded string, with '\\0'
+#define LV_I18N_DECODE_SIZE ${decode_size}
+
+static const uint8_t lv_i18n_codebook[256][2] = {
+${Array.from({ length: 32 }, (_, row) => '    ' + pairs.slice(row * 8, row * 8 + 8).join(', ') + ',').join('\n')}
+};
+`.trim();
+}
+
+
 function lang_plural_template(l, form, data) {
   const loc = to_c(l);
   let result = '';
 
   result = `
-static const char * ${loc}_plurals_${form}[] = {
+static const ${str_type(data)} ${loc}_plurals_${form}[] = {
 `;
 
   let index = 0;
   Object.values(data.pluralKeys).forEach(k => {
     if (!data[l].plural || !data[l].plural[form] || !data[l].plural[form][k]) {
-      result += '  NULL, // ' + index + '=\"' + esc(k) + '\"\n';
+      result += '  ' + str_entry(data, null, l) + ', // ' + index + '=\"' + esc(k) + '\"\n';
     } else {
-      result += '  \"' + esc(data[l].plural[form][k]) + '\", // ' + index + '=\"' + esc(k) + '\"\n';
+      result += '  ' + str_entry(data, data[l].plural[form][k], l) + ', // ' + index + '=\"' + esc(k) + '\"\n';
     }
     index++;
   });
@@ -74,15 +146,15 @@ function lang_singular_template(l, data) {
   let result = '';
 
   result = `
-static const char * ${loc}_singulars[] = {
+static const ${str_type(data)} ${loc}_singulars[] = {
 `;
 
   let index = 0;
   Object.values(data.singularKeys).forEach(k => {
     if (!data[l].singular || !data[l].singular[k]) {
-      result += '  NULL, // ' + index + '=\"' + esc(k) + '\"\n';
+      result += '  ' + str_entry(data, null, l) + ', // ' + index + '=\"' + esc(k) + '\"\n';
     } else {
-      result += '  \"' + esc(data[l].singular[k]) + '\", // ' + index + '=\"' + esc(k) + '\"\n';
+      result += '  ' + str_entry(data, data[l].singular[k], l) + ', // ' + index + '=\"' + esc(k) + '\"\n';
     }
     index++;
   });
@@ -93,22 +165,162 @@ static const char * ${loc}_singulars[] = {
 }
 
 
-function lang_template(args, l, data) {
-  let pforms = Object.keys(data[l].plural);
+// Pre-parsed format strings, for `--format-tokens` mode (see `lib/format.js`)
+function format_tokens_template(formats) {
+  const token = t => `{ ${t.start}, ${t.len}, ${t.arg}, ${t.type} }`;
+  const lists = formats.lists.map(({ name, str, tokens }) => `
+static const lv_i18n_fmt_token_t ${name}[] = { // "${esc(str)}"
+${tokens.map(t => `    ${token(t)},`).join('\n')}
+    { 0, 0, 0, 0 }
+};
+`.trim());
+
+  if (formats.plain_used) {
+    lists.unshift('static const lv_i18n_fmt_token_t lv_i18n_fmt_plain[] = { { 0, 0, 0, 0 } };');
+  }
+
+  return lists.join('\n\n');
+}
+
+
+// Format token lists of translations, in the same order as strings table
+function lang_fmts_template(name, keys, strings, formats) {
+  return `
+static const lv_i18n_fmt_token_t * const ${name}[] = {
+${keys.map((k, i) => `  ${formats.name(strings?.[k])}, // ${i}="${esc(k)}"`).join('\n')}
+};
+`.trim();
+}
+
+
+// Length in bytes, UTF-8 code points and FNV-1a hash, for `--string-info`
+// mode. Must be in sync with `__lv_i18n_str_info()` in C template.
+function str_info(str) {
+  if (!str) return '{ 0, 0, 0 }';
+
+  const len = Buffer.byteLength(str);
+
+  if (len > 0xFFFF) throw new AppError(`Translation is too long for --string-info (max 65535 bytes): "${str}"`);
+
+  return `{ ${len}, ${[ ...str ].length}, 0x${fnv1a(str).toString(16).padStart(8, '0')} }`;
+}
+
+// String metadata of translations, in the same order as strings table
+function lang_info_template(name, keys, strings) {
+  return `
+static const lv_i18n_str_info_t ${name}[] = {
+${keys.map((k, i) => `  ${str_info(strings?.[k])}, // ${i}="${esc(k)}"`).join('\n')}
+};
+`.trim();
+}
+
+
+// Bit per plural key, set when key should be taken from base locale
+function lang_plural_fallback_template(l, data) {
   const loc = to_c(l);
+  let bytes = new Array(Math.ceil(data.pluralKeys.length / 8)).fill(0);
+
+  data[l].pluralFallback.forEach((fallback, i) => {
+    // eslint-disable-next-line no-bitwise
+    if (fallback) bytes[Math.floor(i / 8)] |= 1 << (i % 8);
+  });
 
   return `
-${Object.keys(data[l].singular).length ? lang_singular_template(l, data) : ''}
+static const uint8_t ${loc}_plural_fallback[] = {
+${bytes.map(b => `    0x${b.toString(16).padStart(2, '0')},`).join('\n')}
+};
+`.trim();
+}
 
-${pforms.map(pf => lang_plural_template(l, pf, data)).join('\n\n')}
 
-${create_c_plural_fn(l, `${loc}_plural_fn`)}
+// Size of precomputed plural forms table, for `--plural-table` mode
+const PLURAL_TABLE_SIZE = 200;
 
-static const lv_i18n_lang_t ${loc}_lang = {
-    .locale_name = "${l}",
-${Object.keys(data[l].singular).length ? `    .singulars = ${loc}_singulars,` : ''}
-${pforms.map(pf => `    .plurals[${pf_enum[pf]}] = ${loc}_plurals_${pf},`).join('\n')}
-    .locale_plural_fn = ${loc}_plural_fn
+// Plural rule as data, evaluated by shared interpreter in C: forms for
+// small numbers + bytecode for everything else.
+function plural_rule_template(l) {
+  const loc = to_c(l);
+  const code = create_plural_bytecode(l);
+  const forms = Array.from({ length: PLURAL_TABLE_SIZE }, (_, n) => eval_plural_bytecode(code, n));
+  const rows = (list, per_row, fmt) => Array.from({ length: Math.ceil(list.length / per_row) }, (_, i) =>
+    '    ' + list.slice(i * per_row, (i + 1) * per_row).map(fmt).join(', ') + ',').join('\n');
+
+  return `
+static const uint8_t ${loc}_plural_forms[] = {
+${rows(forms, 20, String)}
+};
+
+static const uint8_t ${loc}_plural_code[] = {
+${rows([ ...code ], 12, b => `0x${b.toString(16).padStart(2, '0')}`)}
+};
+
+static const lv_i18n_plural_rule_t ${loc}_plural_rule = {
+    .forms = ${loc}_plural_forms,
+    .forms_size = ${forms.length},
+    .code = ${loc}_plural_code,
+    .code_size = ${code.length}
+};
+`.trim();
+}
+
+
+// `rule_owner` - first locale with the same plural rules, to share
+// plural function (or table) with it.
+function lang_template(args, l, data, rule_owner) {
+  let pforms = Object.keys(data[l].plural);
+  const loc = to_c(l);
+  const owner = to_c(rule_owner);
+  const has_plural_fallback = data[l].pluralFallback?.some(Boolean);
+  const has_singulars = Object.keys(data[l].singular).length > 0;
+  let plural_rule = '';
+  let fmts = [];
+
+  if (rule_owner === l) {
+    plural_rule = args.plural_table ? plural_rule_template(l) : create_c_plural_fn(l, `${loc}_plural_fn`);
+  }
+
+  if (data.formats) {
+    if (has_singulars) {
+      fmts.push(lang_fmts_template(`${loc}_singular_fmts`, data.singularKeys, data[l].singular, data.formats));
+    }
+    pforms.forEach(pf => {
+      fmts.push(lang_fmts_template(`${loc}_plural_fmts_${pf}`, data.pluralKeys, data[l].plural[pf], data.formats));
+    });
+  }
+
+  if (args.string_info) {
+    if (has_singulars) fmts.push(lang_info_template(`${loc}_singular_info`, data.singularKeys, data[l].singular));
+    pforms.forEach(pf => {
+      fmts.push(lang_info_template(`${loc}_plural_info_${pf}`, data.pluralKeys, data[l].plural[pf]));
+    });
+  }
+
+  return `
+${data.placement ? [ 'hot', 'cold' ].filter(kind => data.placement.locales[l][kind].entries.length)
+    .map(kind => placement_pool_template(l, kind, data.placement.locales[l][kind])).join('\n\n') : ''}
+
+${has_singulars ? lang_singular_template(l, data) : ''}
+
+${pforms.map(pf => lang_plural_template(l, pf, data))
+    .concat(has_plural_fallback ? [ lang_plural_fallback_template(l, data) ] : [], fmts).join('\n\n')}
+
+${plural_rule}
+
+${args.split ? `const lv_i18n_lang_t lv_i18n_lang_${loc}` : `static const lv_i18n_lang_t ${loc}_lang`} = {
+${[
+    `    .locale_name = "${l}",`,
+    data.pool ? '    .pool = lv_i18n_string_pool,' : '',
+    has_singulars ? `    .singulars = ${loc}_singulars,` : '',
+    ...pforms.map(pf => `    .plurals[${pf_enum[pf]}] = ${loc}_plurals_${pf},`),
+    has_plural_fallback ? `    .plural_fallback = ${loc}_plural_fallback,` : '',
+    data.formats && has_singulars ? `    .singular_fmts = ${loc}_singular_fmts,` : '',
+    ...(data.formats ? pforms : []).map(pf => `    .plural_fmts[${pf_enum[pf]}] = ${loc}_plural_fmts_${pf},`),
+    args.string_info && has_singulars ? `    .singular_info = ${loc}_singular_info,` : '',
+    ...(args.string_info ? pforms : []).map(pf => `    .plural_info[${pf_enum[pf]}] = ${loc}_plural_info_${pf},`),
+    args.split ? '    .keys_hash = LV_I18N_KEYS_HASH,' : '',
+    args.resolve_fallback ? '    .resolved = 1,' : '',
+    args.plural_table ? `    .plural_rule = &${owner}_plural_rule` : `    .locale_plural_fn = ${owner}_plural_fn`
+  ].filter(Boolean).join('\n')}
 };
 `.trim();
 }
@@ -122,34 +334,234 @@ function generate_idx(keys) {
   return result;
 }
 
-function getIDX2(keys, i) {
-  let result = 'LV_I18N_ID_NOT_FOUND';
+function generate_hash(name, keys) {
+  const { seed, disp, slots } = create_perfect_hash(keys);
 
-  let key = keys[i];
-  if (key) {
-    result = '(!strcmp(str, \"' + esc(key) + '\")?' + i + ':' + getIDX2(keys, i + 1) + ')';
-  }
-  return result;
+  return `
+static const uint32_t ${name}_hash_seed = ${seed};
+
+static const int32_t ${name}_hash_disp[] = {
+${disp.map(d => `    ${d},`).join('\n')}
+};
+
+static const uint16_t ${name}_hash_slots[] = {
+${slots.map(s => `    ${s},`).join('\n')}
+};
+`.trim();
 }
 
+function hex(val) {
+  return `0x${val.toString(16).padStart(8, '0')}u`;
+}
+
+function generate_literal_hash(name, keys, { hashes, disp, slots }) {
+  return `
+static const int32_t lv_i18n_idx_${name}_disp[] = {
+${disp.map(d => `    ${d},`).join('\n')}
+};
+
+static const uint16_t lv_i18n_idx_${name}_slots[] = {
+${slots.map(s => `    ${s},`).join('\n')}
+};
+
+static const uint32_t lv_i18n_idx_${name}_hashes[] = {
+${hashes.map((h, i) => `    ${hex(h)},${keys.length ? ` // ${i}="${esc(keys[i])}"` : ''}`).join('\n')}
+};
+
+static const char * const lv_i18n_idx_${name}_keys[] = {
+${(keys.length ? keys : [ '' ]).map(k => `    "${esc(k)}",`).join('\n')}
+};
+
+#define LV_I18N_IDX_${name}(str) lv_i18n_idx_find("" str, sizeof("" str), LV_I18N_HASH(str), \\
+    lv_i18n_idx_${name}_disp, ${disp.length}, lv_i18n_idx_${name}_slots, lv_i18n_idx_${name}_hashes, \\
+    lv_i18n_idx_${name}_keys, ${keys.length})
+`.trim();
+}
+
+// Key => index mapping for `--optimize` mode. String literal hash is
+// calculated by macro, then resolved to index via perfect hash over
+// static tables. All that is folded to constant by compiler, and call
+// site size does not depend on amount of keys. Tables must stay in header
+// for that, so `-O0` builds get a copy per translation unit (see README).
 module.exports.getIDX = function (data) {
-  let result = '#define LV_I18N_IDX_s(str) ' + getIDX2(data.singularKeys, 0) + '\n';
-  result += '#define LV_I18N_IDX_p(str) ' + getIDX2(data.pluralKeys, 0) + '\n';
-  return result;
+  const { weights, sets } = create_literal_perfect_hash([ data.singularKeys, data.pluralKeys ]);
+
+  let terms = weights.slice(1).map((w, i) => `LV_I18N_HASH_C(s, ${i}, ${hex(w)})`);
+
+  return `
+// Compile-time hash of string literal (concatenation with "" rejects pointers)
+#define LV_I18N_HASH_C(s, i, w) ((uint32_t)(uint8_t)(s)[(i) < sizeof(s) ? (i) : sizeof(s) - 1] * (w))
+#define LV_I18N_HASH_S(s) ((uint32_t)sizeof(s) * ${hex(weights[0])}${terms.map(t => ` + \\\n    ${t}`).join('')})
+#define LV_I18N_HASH(str) LV_I18N_HASH_S("" str)
+
+${generate_literal_hash('s', data.singularKeys, sets[0])}
+
+${generate_literal_hash('p', data.pluralKeys, sets[1])}
+`.trimStart();
 };
 
-module.exports.getRAW = function (args, locales, data) {
+// Declarations of `--split` mode locales (see `lv_i18n_lang_t` externs in header)
+module.exports.getSplitLocales = function (locales) {
+  return `#define LV_I18N_SPLIT_LOCALES(X)${locales.map(l => ` X(${to_c(l)})`).join('')}\n`;
+};
+
+// Single locale file for `--split` mode, linked separately from core
+module.exports.getLocaleRAW = function (args, l, data) {
+  let langs = [ lang_template(args, l, data, l) ];
+
+  if (data.formats) langs.unshift(format_tokens_template(data.formats));
+  if (data.pool) langs.unshift(string_pool_template(data.pool));
+
+  return `// "${l}" translations. Link this file and call \`lv_i18n_register_lang(&lv_i18n_lang_${to_c(l)})\`.
+
+#include "./lv_i18n.h"
+
+${plural_helpers}
+
+${langs.join('\n\n')}
+`;
+};
+
+// Locale IDs for `lv_i18n_set_locale_by_idx()`, in language pack order
+module.exports.getLocaleEnum = function (locales) {
+  return `
+typedef enum {
+${locales.map((l, i) => `    LV_I18N_LOCALE_${to_c(l).toUpperCase()} = ${i},`).join('\n')}
+    LV_I18N_LOCALE_COUNT = ${locales.length}
+} lv_i18n_locale_t;
+`.trimStart();
+};
+
+// Phrases in ID order, for C++ front end (`--cpp` option)
+module.exports.getCppKeys = function (data) {
+  const list = keys => keys.map(k => `    "${esc(k)}",\n`).join('');
+
+  return `
+// Phrases in ID order, NULL-terminated
+inline constexpr const char * singular_keys[] = {
+${list(data.singularKeys)}    nullptr
+};
+
+inline constexpr const char * plural_keys[] = {
+${list(data.pluralKeys)}    nullptr
+};
+`.trimStart();
+};
+
+// Phrase IDs are in [0, count) ranges
+module.exports.getKeysCount = function (data) {
+  return `
+#define LV_I18N_SINGULAR_COUNT ${data.singularKeys.length}
+#define LV_I18N_PLURAL_COUNT ${data.pluralKeys.length}
+`.trimStart();
+};
+
+// Phrase index lists of source files (`--screens` option), initializers
+// for `lv_i18n_get_singular_batch()` / `lv_i18n_get_plural_batch()`.
+// Phrases are in order of first use, unknown ones are LV_I18N_ID_NOT_FOUND.
+module.exports.getScreens = function (data, screens) {
+  const ids = keys => new Map(keys.map((k, i) => [ k, i ]));
+  const singular_ids = ids(data.singularKeys);
+  const plural_ids = ids(data.pluralKeys);
+
+  const list = (macro, keys, all) => {
+    if (!keys.length) return '';
+
+    const entries = keys.map(k => {
+      const id = all.has(k) ? all.get(k) : 'LV_I18N_ID_NOT_FOUND';
+
+      return `    ${id}, /* "${esc(k).replace(/\*\//g, '*\\/')}" */ \\\n`;
+    });
+
+    return `#define ${macro} { \\\n${entries.join('')}}\n`;
+  };
+
+  return screens.map(s => `// Phrases of "${esc(s.fileName)}"\n` +
+    list(`LV_I18N_SCREEN_SINGULARS_${s.name}`, s.singular, singular_ids) +
+    list(`LV_I18N_SCREEN_PLURALS_${s.name}`, s.plural, plural_ids)).join('\n');
+};
+
+function langs_template(args, locales, data) {
+  // Locales with the same CLDR rules (en / de, ru / uk, ...) share code
+  let rule_owners = {};
+
+  locales.forEach(l => {
+    const fn = create_c_plural_fn(l, 'fn');
+
+    if (!rule_owners[fn]) rule_owners[fn] = l;
+  });
+
+  let langs = locales.map(l => lang_template(args, l, data, rule_owners[create_c_plural_fn(l, 'fn')]));
+
+  if (data.formats) langs.unshift(format_tokens_template(data.formats));
+  if (data.pool) langs.unshift(string_pool_template(data.pool));
+
   return `
 ${plural_helpers}
 
-${locales.map(l => lang_template(args, l, data)).join('\n\n')}
+${langs.join('\n\n')}
 
 const lv_i18n_language_pack_t lv_i18n_language_pack[] = {
 ${locales.map(l => `    &${to_c(l)}_lang,`).join('\n')}
     NULL // End mark
 };
 
-#ifndef LV_I18N_OPTIMIZE
+// Language pack indexes, sorted by canonical locale name (binary search)
+static const uint16_t lv_i18n_locale_order[] = {
+${locales.map((l, i) => i)
+    .sort((a, b) => (canonical(locales[a]) < canonical(locales[b]) ? -1 : 1))
+    .map(i => `    ${i}, // ${canonical(locales[i])}`).join('\n')}
+};
+`.trim();
+}
+
+// `--split` mode. Locales are in separate files, and are registered in
+// runtime, so core has only names.
+function registry_template(locales) {
+  return `
+${plural_helpers}
+
+// Locale names by ID, to match registered locales
+static const char * const lv_i18n_locale_names[] = {
+${locales.map(l => `    "${l}",`).join('\n')}
+};
+
+// Registered locales by ID, NULL if not registered
+static const lv_i18n_lang_t * lv_i18n_registry[LV_I18N_LOCALE_COUNT];
+
+// Registered locales in ID order (base first), NULL-terminated
+lv_i18n_language_pack_t lv_i18n_language_pack[LV_I18N_LOCALE_COUNT + 1];
+`.trim();
+}
+
+// Changed keys per pair of locales, for `--locale-diff` mode (see
+// `lib/locale_diff.js`)
+function locale_diff_template(diff) {
+  const bitmaps = diff.bitmaps.map(({ name, bytes, locales }) => `
+static const uint8_t ${name}[] = { // ${locales.join(' <> ')}
+${bytes.map(b => `    0x${b.toString(16).padStart(2, '0')},`).join('\n')}
+};
+`.trim());
+
+  return `
+${bitmaps.join('\n\n')}
+
+// Pairs of locales (a, b), a < b, NULL if nothing changed
+static const uint8_t * const lv_i18n_locale_diff[] = {
+${diff.pairs.length ? diff.pairs.map(name => `    ${name || 'NULL'},`).join('\n') : '    NULL'}
+};
+`.trim();
+}
+
+module.exports.getRAW = function (args, locales, data) {
+  return `
+${args.split ? registry_template(locales) : langs_template(args, locales, data)}
+
+${data.codebook ? codebook_template(data.codebook, data.decode_size) : ''}
+
+${data.diff ? locale_diff_template(data.diff) : ''}
+
+#if !defined(LV_I18N_OPTIMIZE) || defined(LV_I18N_STATS)
 
 static const char * singular_idx[] = {
 ${generate_idx(data.singularKeys)}
@@ -161,5 +573,13 @@ ${generate_idx(data.pluralKeys)}
 
 #endif
 
+#if !defined(LV_I18N_OPTIMIZE) && !defined(LV_I18N_LINEAR_LOOKUP)
+
+${generate_hash('singular', data.singularKeys)}
+
+${generate_hash('plural', data.pluralKeys)}
+
+#endif
+
 `;
 };
@@ -0,0 +1,175 @@
+// Compressed string pool for `--compress` mode. Strings are encoded with
+// byte pair encoding: byte values, not used by any translation, become
+// codes of the most frequent pairs (recursively). Codebook is trained on
+// all locales at once and shared.
+//
+// Each string is encoded separately and ends with '\0', so it can be
+// decoded alone, by offset. Codebook is a table of 256 pairs, where
+// `{ 0, 0 }` means literal byte. Offset 0 is reserved for NULL, as in
+// plain string pool (see `lib/string_pool.js`).
+//
+'use strict';
+
+
+// Max nesting of pairs. Must be in sync with `LV_I18N_DECODE_DEPTH` in C
+// template (stack size of decoder is depth + 1).
+const MAX_DEPTH = 15;
+
+
+// Replace pair in place, returns the same sequence if nothing changed
+function replace_pair(seq, a, b, code) {
+  let n = 0;
+
+  for (let i = 0; i < seq.length; i++) {
+    if (seq[i] === a && seq[i + 1] === b && i + 1 < seq.length) {
+      seq[n++] = code;
+      i++;
+    } else {
+      seq[n++] = seq[i];
+    }
+  }
+
+  return n === seq.length ? seq : seq.subarray(0, n);
+}
+
+
+function create_codebook(strings) {
+  const unique = [ ...new Set(strings.filter(Boolean)) ];
+  let seqs = unique.map(str => new Uint8Array(Buffer.from(str, 'utf8')));
+
+  const used = new Uint8Array(256);
+  const depth = new Uint8Array(256);
+  const dict = new Uint8Array(512);
+  const merges = [];
+  const counts = new Int32Array(65536);
+  const visited = new Uint8Array(seqs.length);
+
+  // Sequences with pair, to update only those on merge (can contain
+  // repeated & stale entries)
+  const where = new Map();
+
+  // Add (or remove) pairs of sequence to counts. On add, register only
+  // pairs with new `code`, others are registered already.
+  const count = (i, sign, code) => {
+    const seq = seqs[i];
+
+    for (let j = 0; j + 1 < seq.length; j++) {
+      // eslint-disable-next-line no-bitwise
+      const pair = (seq[j] << 8) | seq[j + 1];
+
+      counts[pair] += sign;
+
+      if (sign > 0 && (code < 0 || seq[j] === code || seq[j + 1] === code)) {
+        if (!where.has(pair)) where.set(pair, []);
+        where.get(pair).push(i);
+      }
+    }
+  };
+
+  seqs.forEach(seq => seq.forEach(b => { used[b] = 1; }));
+  seqs.forEach((_, i) => count(i, 1, -1));
+
+  for (let code = 1; code < 256; code++) {
+    if (used[code]) continue;
+
+    // Pair must repeat, to save more than it costs
+    let best = -1;
+    let best_count = 2;
+
+    for (let pair = 0; pair < 65536; pair++) {
+      // eslint-disable-next-line no-bitwise
+      if (counts[pair] > best_count && Math.max(depth[pair >> 8], depth[pair & 0xFF]) < MAX_DEPTH) {
+        best = pair;
+        best_count = counts[pair];
+      }
+    }
+
+    if (best < 0) break;
+
+    // eslint-disable-next-line no-bitwise
+    const a = best >> 8, b = best & 0xFF;
+
+    dict[code * 2] = a;
+    dict[code * 2 + 1] = b;
+    depth[code] = Math.max(depth[a], depth[b]) + 1;
+    merges.push([ a, b, code ]);
+
+    where.get(best).forEach(i => {
+      if (visited[i] === code) return;
+      visited[i] = code;
+
+      count(i, -1, code);
+      seqs[i] = replace_pair(seqs[i], a, b, code);
+      count(i, 1, code);
+    });
+    where.delete(best);
+  }
+
+  const encoded = new Map(unique.map((str, i) => [ str, seqs[i] ]));
+
+  return {
+    dict,
+    merges,
+    // Codes of string, without terminating zero
+    encode: str => {
+      if (encoded.has(str)) return encoded.get(str);
+
+      let seq = new Uint8Array(Buffer.from(str, 'utf8'));
+
+      merges.forEach(([ a, b, code ]) => { seq = replace_pair(seq, a, b, code); });
+      return seq;
+    }
+  };
+}
+
+
+// Bytes & table reads to decode codes of string
+function decode(dict, codes) {
+  const out = [];
+  let steps = 0;
+
+  const expand = c => {
+    steps++;
+    if (dict[c * 2] === 0) out.push(c);
+    else {
+      expand(dict[c * 2]);
+      expand(dict[c * 2 + 1]);
+    }
+  };
+
+  codes.forEach(expand);
+
+  return { str: Buffer.from(out).toString('utf8'), steps };
+}
+
+
+// Same interface as `create_string_pool()`, entries have encoded `bytes`
+function create_compressed_pool(strings, codebook) {
+  const entries = [];
+  const offsets = new Map();
+  let size = 1;
+
+  strings.forEach(str => {
+    if (!str || offsets.has(str)) return;
+
+    const bytes = codebook.encode(str);
+
+    offsets.set(str, size);
+    entries.push({ str, bytes, offset: size });
+    size += bytes.length + 1;
+  });
+
+  return {
+    size,
+    offset_type: size <= 0xFFFF ? 'uint16_t' : 'uint32_t',
+    entries,
+    // Offset of string in pool, 0 for NULL / empty
+    offset: str => (str ? offsets.get(str) : 0)
+  };
+}
+
+
+module.exports.MAX_DEPTH = MAX_DEPTH;
+module.exports.create_codebook = create_codebook;
+module.exports.create_compressed_pool = create_compressed_pool;
+module.exports.decode = decode;
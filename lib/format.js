@@ -0,0 +1,218 @@
+// Printf-like format strings, pre-parsed for `lv_i18n_format()` in
+// `--format-tokens` mode. Must be in sync with
+// `__lv_i18n_fmt_parse_spec()` / `__lv_i18n_fmt_next()` in C.
+//
+// Supported: %[N$][flags][width][.precision][hh|h|l|ll|z]conv, where
+// conv is one of `diuxXocspfFeEgGaA`. Invalid specs are printed as is.
+//
+// Token (offsets are in UTF-8 bytes):
+//
+// - literal:   { start, len, arg: 0, type: 0 }
+// - argument:  { start, len, arg, type }, where start/len cover spec
+//   without `N$` ("-5d"), and arg is 1-based argument number
+// - type only: { start: 0, len: 0, arg, type } - argument, not printed by
+//   this string, but needed to read next ones from va_list
+//
+'use strict';
+
+
+const AppError = require('./app_error');
+
+
+// Max argument number, `LV_I18N_FORMAT_MAX_ARGS` in C
+const MAX_ARGS = 9;
+// Max spec length without `%` and `N$`
+const MAX_SPEC = 15;
+
+const CONVERSIONS = 'diuxXocspfFeEgGaA';
+
+// Must be in sync with `LV_I18N_ARG_*` in C
+const arg_types = {
+  int: 1, uint: 2, long: 3, ulong: 4, llong: 5, ullong: 6, size: 7, double: 8, str: 9, ptr: 10
+};
+
+const is_digit = c => c >= 0x30 && c <= 0x39;
+
+
+function spec_type(length, conv) {
+  if (conv === 'c') return arg_types.int;
+  if (conv === 's') return arg_types.str;
+  if (conv === 'p') return arg_types.ptr;
+  if ('fFeEgGaA'.includes(conv)) return arg_types.double;
+  if (length === 'z') return arg_types.size;
+
+  const signed = conv === 'd' || conv === 'i';
+
+  if (length === 'l') return signed ? arg_types.long : arg_types.ulong;
+  if (length === 'll') return signed ? arg_types.llong : arg_types.ullong;
+  return signed ? arg_types.int : arg_types.uint;
+}
+
+
+// Parse spec after `%` at position `p`, returns null if invalid
+function parse_spec(b, p) {
+  let arg = 0;
+  let j = p;
+
+  while (is_digit(b[j])) arg = arg * 10 + b[j++] - 0x30;
+
+  if (j > p && b[j] === 0x24 /* $ */) {
+    if (arg < 1 || arg > MAX_ARGS) return null;
+    p = j + 1;
+  } else {
+    arg = 0;
+  }
+
+  const start = p;
+
+  while (b[p] !== undefined && '-+ #0'.includes(String.fromCharCode(b[p]))) p++;
+  while (is_digit(b[p])) p++;
+  if (b[p] === 0x2e /* . */) {
+    p++;
+    while (is_digit(b[p])) p++;
+  }
+
+  let length = '';
+
+  if (b[p] === 0x68 /* h */ || b[p] === 0x6c /* l */) {
+    length = String.fromCharCode(b[p++]);
+    if (b[p] === b[p - 1]) length += String.fromCharCode(b[p++]);
+  } else if (b[p] === 0x7a /* z */) {
+    length = 'z';
+    p++;
+  }
+
+  const conv = b[p] === undefined ? '' : String.fromCharCode(b[p]);
+
+  if (!conv || !CONVERSIONS.includes(conv) || p + 1 - start > MAX_SPEC) return null;
+
+  return { arg, start, end: p + 1, type: spec_type(length, conv) };
+}
+
+
+function parse_format(str) {
+  const b = Buffer.from(str, 'utf8');
+  const tokens = [];
+  let lit = 0;
+  let seq = 0;
+  let i = 0;
+
+  const flush = end => {
+    if (end > lit) tokens.push({ start: lit, len: end - lit, arg: 0, type: 0 });
+  };
+
+  while (i < b.length) {
+    if (b[i] !== 0x25 /* % */) {
+      i++;
+      continue;
+    }
+
+    // "%%" - literal, starting from the second "%"
+    if (b[i + 1] === 0x25) {
+      flush(i);
+      lit = i + 1;
+      i += 2;
+      continue;
+    }
+
+    const spec = parse_spec(b, i + 1);
+
+    if (!spec) {
+      i++;
+      continue;
+    }
+
+    let arg = spec.arg || ++seq;
+
+    // Out of range sequential arg is printed as is, like invalid spec
+    if (arg > MAX_ARGS) {
+      i++;
+      continue;
+    }
+
+    flush(i);
+    tokens.push({ start: spec.start, len: spec.end - spec.start, arg, type: spec.type });
+    i = lit = spec.end;
+  }
+
+  flush(b.length);
+
+  return tokens;
+}
+
+
+// Build token lists for all translations with `%`. Argument types are
+// checked to be the same in all locales & plural forms of each key, and
+// used to fill gaps ("%2$s" without "%1$d").
+//
+// `only` - locales to build lists for (all by default), to emit tables of
+// each locale separately. Types are still checked over all `locales`.
+function create_format_tables(locales, data, only = locales) {
+  const lists = new Map();
+
+  function add_key(key, strings) {
+    const types = [];
+    const parsed = strings.filter(s => s.str && s.str.includes('%'))
+      .map(s => Object.assign({ tokens: parse_format(s.str) }, s));
+
+    parsed.forEach(({ locale, tokens }) => tokens.filter(t => t.arg).forEach(t => {
+      if (types[t.arg] && types[t.arg] !== t.type) {
+        throw new AppError(`Format argument ${t.arg} of "${key}" has different type in ${locale}`);
+      }
+      types[t.arg] = t.type;
+    }));
+
+    parsed.forEach(({ str, locale, tokens }) => {
+      if (lists.has(str) || !only.includes(locale)) return;
+
+      // Token offsets are uint16_t
+      if (Buffer.byteLength(str) > 0xFFFF) {
+        throw new AppError(`Translation of "${key}" is too long for format tokens (${locale})`);
+      }
+
+      const used = new Set(tokens.map(t => t.arg));
+      const max = Math.max(0, ...used);
+      const gaps = [];
+
+      for (let arg = 1; arg < max; arg++) {
+        if (used.has(arg)) continue;
+        if (!types[arg]) {
+          throw new AppError(`Format argument ${arg} of "${key}" is not used in any locale, type unknown (${locale})`);
+        }
+        gaps.push({ start: 0, len: 0, arg, type: types[arg] });
+      }
+
+      lists.set(str, gaps.concat(tokens));
+    });
+  }
+
+  data.singularKeys.forEach(k => {
+    add_key(k, locales.map(l => ({ locale: l, str: data[l].singular[k] })));
+  });
+
+  data.pluralKeys.forEach(k => {
+    add_key(k, locales.flatMap(l => Object.values(data[l].plural).map(form => ({ locale: l, str: form[k] }))));
+  });
+
+  const names = new Map([ ...lists.keys() ].map((str, i) => [ str, `lv_i18n_fmt_${i}` ]));
+  const result = {
+    lists: [ ...lists.entries() ].map(([ str, tokens ]) => ({ name: names.get(str), str, tokens })),
+    // Set when `lv_i18n_fmt_plain` is referenced (to not emit unused table)
+    plain_used: false,
+    // Token list name for translation, `lv_i18n_fmt_plain` without `%`
+    name: str => {
+      if (!str) return 'NULL';
+      if (names.has(str)) return names.get(str);
+      result.plain_used = true;
+      return 'lv_i18n_fmt_plain';
+    }
+  };
+
+  return result;
+}
+
+
+module.exports.MAX_ARGS = MAX_ARGS;
+module.exports.arg_types = arg_types;
+module.exports.parse_format = parse_format;
+module.exports.create_format_tables = create_format_tables;
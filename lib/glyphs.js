@@ -0,0 +1,131 @@
+// Unicode code points, used by translations of each locale, to build font
+// subsets (see `--glyphs` option). Ranges are in `lv_font_conv --range`
+// format: "0x20-0x7e,0x401".
+//
+// Locale needs glyphs of base locale strings, shown as fallback. Format
+// specs are not shown, but printed arguments are, so numeric specs add
+// digits & signs instead ("%d" => "-0123456789"). Strings (`%s`, `%c`) are
+// provided by application, and are not counted.
+//
+'use strict';
+
+
+const { parse_format } = require('./format');
+const { getPluralKeys } = require('./plurals');
+
+
+const DIGITS = '0123456789';
+const HEX = 'abcdef';
+
+// Glyphs, printed by argument, per conversion
+const ARG_GLYPHS = {
+  d: '-' + DIGITS,
+  i: '-' + DIGITS,
+  u: DIGITS,
+  o: DIGITS,
+  x: DIGITS + HEX,
+  X: DIGITS + HEX.toUpperCase(),
+  p: DIGITS + HEX + 'x',
+  f: '-.' + DIGITS,
+  F: '-.' + DIGITS,
+  e: '-+.e' + DIGITS,
+  E: '-+.E' + DIGITS,
+  g: '-+.e' + DIGITS,
+  G: '-+.E' + DIGITS,
+  a: '-+.xp' + DIGITS + HEX,
+  A: '-+.XP' + DIGITS + HEX.toUpperCase()
+};
+
+
+// Add glyphs of displayed text to set
+function add_glyphs(set, str) {
+  const text = str.includes('%') ? format_glyphs(str) : str;
+
+  for (const ch of text) {
+    const cp = ch.codePointAt(0);
+
+    // Control chars ("\n") have no glyphs
+    if (cp >= 0x20) set.add(cp);
+  }
+}
+
+function format_glyphs(str) {
+  const b = Buffer.from(str);
+
+  return parse_format(str).map(t => {
+    if (!t.arg) return b.subarray(t.start, t.start + t.len).toString();
+    if (!t.len) return '';
+    return ARG_GLYPHS[String.fromCharCode(b[t.start + t.len - 1])] || '';
+  }).join('');
+}
+
+
+// Strings, shown in locale `l`, including fallbacks to base locale
+function locale_strings(l, base, data) {
+  let strings = [];
+
+  data.singularKeys.forEach(k => {
+    const str = data[l].singular[k] || data[base].singular[k];
+
+    if (str) strings.push(str);
+  });
+
+  const forms = getPluralKeys(l);
+
+  data.pluralKeys.forEach(k => {
+    const own = forms.map(form => data[l].plural[form]?.[k]);
+
+    strings.push(...own.filter(Boolean));
+
+    // Missed form is taken from base locale, with its own plural rule
+    if (own.some(str => !str) && l !== base) {
+      strings.push(...Object.values(data[base].plural).map(form => form[k]).filter(Boolean));
+    }
+  });
+
+  return strings;
+}
+
+
+// Sorted code points => "0x20-0x7e,0x401"
+function to_ranges(set) {
+  const cps = [ ...set ].sort((a, b) => a - b);
+  const hex = cp => '0x' + cp.toString(16);
+  let ranges = [];
+
+  for (let i = 0; i < cps.length; i++) {
+    let j = i;
+
+    while (j + 1 < cps.length && cps[j + 1] === cps[j] + 1) j++;
+
+    ranges.push(i === j ? hex(cps[i]) : `${hex(cps[i])}-${hex(cps[j])}`);
+    i = j;
+  }
+
+  return ranges.join(',');
+}
+
+
+// `{ all: { count, range }, locales: { "en-GB": { count, range }, ... } }`,
+// first locale is base one.
+function create_glyphs(locales, data) {
+  const all = new Set();
+  const result = { all: null, locales: {} };
+
+  locales.forEach(l => {
+    const set = new Set();
+
+    locale_strings(l, locales[0], data).forEach(str => add_glyphs(set, str));
+    set.forEach(cp => all.add(cp));
+
+    result.locales[l] = { count: set.size, range: to_ranges(set) };
+  });
+
+  result.all = { count: all.size, range: to_ranges(all) };
+
+  return result;
+}
+
+
+module.exports.to_ranges = to_ranges;
+module.exports.create_glyphs = create_glyphs;
@@ -0,0 +1,202 @@
+// Hash helpers. Must produce exactly the same values as C code
+// in `lv_i18n.template.c`.
+//
+'use strict';
+
+/* eslint-disable no-bitwise */
+
+
+const AppError = require('./app_error');
+
+
+// Average keys per bucket. Bigger value = smaller displacement table,
+// but slower perfect hash generation.
+const BUCKET_SIZE = 4;
+// Max displacement to try before switching to another seed.
+const MAX_DISPLACEMENT = 1 << 20;
+const MAX_SEED = 1000;
+// Phrase IDs and slots are `uint16_t` in C, 0xFFFF is LV_I18N_ID_NOT_FOUND.
+const MAX_KEYS = 0xFFFF;
+
+
+// FNV-1a over UTF-8 bytes (or raw buffer), with seed mixed into offset basis
+function fnv1a(str, seed) {
+  let h = (0x811c9dc5 ^ (seed || 0)) >>> 0;
+
+  for (let b of (Buffer.isBuffer(str) ? str : Buffer.from(str, 'utf8'))) {
+    h ^= b;
+    h = Math.imul(h, 0x01000193) >>> 0;
+  }
+
+  return h;
+}
+
+
+// Murmur3 finalizer, applied to string hash xor-ed with displacement.
+function mix(h, d) {
+  h = (h ^ d) >>> 0;
+  h ^= h >>> 16;
+  h = Math.imul(h, 0x85ebca6b);
+  h ^= h >>> 13;
+  h = Math.imul(h, 0xc2b2ae35);
+  h ^= h >>> 16;
+  return h >>> 0;
+}
+
+
+// Distribute unique 32-bit hashes to slots, returns displacement table
+// and slot => index mapping.
+function place(hashes) {
+  const n = hashes.length;
+  const r = Math.ceil(n / BUCKET_SIZE);
+  const buckets = Array.from({ length: r }, () => []);
+
+  hashes.forEach((h, i) => buckets[mix(h, 0) % r].push(i));
+
+  // Place big buckets first, while table is almost empty.
+  const order = buckets.map((b, i) => i)
+    .sort((a, b) => (buckets[b].length - buckets[a].length) || (a - b));
+
+  const taken = new Uint8Array(n);
+  const slots = new Array(n).fill(0);
+  const disp = new Array(r).fill(0);
+  let next_free = 0;
+
+  for (let b of order) {
+    const items = buckets[b];
+
+    if (!items.length) break;
+
+    // Single key - put directly into free slot, encoded as negative value
+    if (items.length === 1) {
+      while (taken[next_free]) next_free++;
+      taken[next_free] = 1;
+      slots[next_free] = items[0];
+      disp[b] = -next_free - 1;
+      continue;
+    }
+
+    let found = false;
+
+    for (let d = 1; d < MAX_DISPLACEMENT && !found; d++) {
+      const pos = items.map(i => mix(hashes[i], d) % n);
+
+      if (pos.some(p => taken[p]) || new Set(pos).size !== pos.length) continue;
+
+      pos.forEach((p, j) => {
+        taken[p] = 1;
+        slots[p] = items[j];
+      });
+      disp[b] = d;
+      found = true;
+    }
+
+    if (!found) return null;
+  }
+
+  return { disp, slots };
+}
+
+
+function check_keys_count(keys) {
+  if (keys.length > MAX_KEYS) {
+    throw new AppError(`Too many phrases (${keys.length}), max ${MAX_KEYS} of each kind (singular / plural)`);
+  }
+}
+
+
+function try_seed(keys, seed) {
+  const hashes = keys.map(k => fnv1a(k, seed));
+
+  // String hashes must be unique, or displacement will not help.
+  if (new Set(hashes).size !== hashes.length) return null;
+
+  const result = place(hashes);
+
+  return result && { seed, disp: result.disp, slots: result.slots };
+}
+
+
+// Build minimal perfect hash (hash & displace) for list of unique keys.
+//
+// Lookup:
+//
+// h    = fnv1a(key, seed)
+// d    = disp[mix(h, 0) % disp.length]
+// slot = d < 0 ? -d - 1 : mix(h, d) % keys.length
+// idx  = slots[slot] (then verify keys[idx] === key)
+//
+function create_perfect_hash(keys) {
+  // C does not allow empty arrays, use dummy tables
+  if (!keys.length) return { seed: 0, disp: [ 0 ], slots: [ 0 ] };
+
+  check_keys_count(keys);
+
+  for (let seed = 0; seed < MAX_SEED; seed++) {
+    const result = try_seed(keys, seed);
+
+    if (result) return result;
+  }
+
+  throw new Error('Failed to create perfect hash');
+}
+
+
+// Weights for compile-time string hash, used by `--optimize` mode:
+//
+// hash = sizeof(str) * weights[0] + sum(str[i] * weights[i + 1])
+//
+// Unlike FNV, this can be written as flat sum in C macro, without deep
+// nesting, and any C99 compiler is able to fold it for string literals.
+function create_literal_hash_weights(seed, len) {
+  return Array.from({ length: len + 1 }, (_, i) => (mix(seed, i + 1) | 1) >>> 0);
+}
+
+
+function literal_hash(str, weights) {
+  const bytes = Buffer.from(str, 'utf8');
+  let h = Math.imul(bytes.length + 1, weights[0]);
+
+  bytes.forEach((b, i) => { h = (h + Math.imul(b, weights[i + 1])) >>> 0; });
+
+  return h >>> 0;
+}
+
+
+// Search weights, giving unique hashes for each key set, and build
+// perfect hash tables over those. Used to resolve string literals to
+// indexes at compile time.
+function create_literal_perfect_hash(key_sets) {
+  key_sets.forEach(check_keys_count);
+
+  const len = key_sets.flat().reduce((max, k) => Math.max(max, Buffer.byteLength(k, 'utf8')), 0);
+
+  for (let seed = 0; seed < MAX_SEED; seed++) {
+    const weights = create_literal_hash_weights(seed, len);
+    const sets = [];
+
+    for (let keys of key_sets) {
+      const hashes = keys.map(k => literal_hash(k, weights));
+
+      if (new Set(hashes).size !== hashes.length) break;
+
+      // C does not allow empty arrays, use dummy tables
+      const result = keys.length ? place(hashes) : { disp: [ 0 ], slots: [ 0 ] };
+
+      if (!result) break;
+
+      sets.push({ hashes: keys.length ? hashes : [ 0 ], disp: result.disp, slots: result.slots });
+    }
+
+    if (sets.length === key_sets.length) return { weights, sets };
+  }
+
+  throw new Error('Failed to create literal hash');
+}
+
+
+module.exports.fnv1a = fnv1a;
+module.exports.mix = mix;
+module.exports.create_perfect_hash = create_perfect_hash;
+module.exports.literal_hash = literal_hash;
+module.exports.create_literal_perfect_hash = create_literal_perfect_hash;
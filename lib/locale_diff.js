@@ -0,0 +1,102 @@
+// Keys with different text after locale switch, for `--locale-diff` option.
+//
+// Text is compared as shown in runtime, after fallbacks: missing singular
+// is taken from base locale, missing plural form - from base locale with
+// its own plural rule. So switch between locales, differing only in a few
+// phrases (en-GB / en-US), marks only those.
+//
+// Bitmap has bit per singular key, then bit per plural key. Diff of (a, b)
+// is the same as of (b, a), so only pairs with a < b are stored, and equal
+// bitmaps are shared.
+//
+'use strict';
+
+
+const { create_c_plural_fn } = require('./plurals');
+
+
+// Plural forms, shown in locale: own ones, or all from base locale if
+// phrase is not translated at all
+function plural_forms(l, base, data, k) {
+  const own = loc => Object.entries(data[loc].plural)
+    .filter(([ , strs ]) => strs[k])
+    .map(([ form, strs ]) => [ form, strs[k] ]);
+  const forms = own(l);
+
+  return forms.length ? { l, forms } : { l: base, forms: own(base) };
+}
+
+function plural_equal(a, b, rules) {
+  if (a.l === b.l) return true;
+  if (rules[a.l] !== rules[b.l]) return false;
+  if (a.forms.length !== b.forms.length) return false;
+
+  const strs = new Map(a.forms);
+
+  return b.forms.every(([ form, str ]) => strs.get(form) === str);
+}
+
+
+// Index of pair (a, b), a < b, in list of `n` locales. Must be in sync
+// with `__lv_i18n_locale_diff()` in C template.
+function pair_index(a, b, n) {
+  return a * (2 * n - a - 1) / 2 + (b - a - 1);
+}
+
+
+// `{ bitmaps: [ { name, bytes, locales } ], pairs: [ name or null ] }`,
+// where pair without changes is null. `locales` is the first pair, using
+// bitmap. First locale is base one.
+function create_locale_diff(locales, data) {
+  const base = locales[0];
+  const n = locales.length;
+  const keys = data.singularKeys.length + data.pluralKeys.length;
+  const rules = {};
+  const bitmaps = [];
+  const names = new Map();
+  const pairs = new Array(n * (n - 1) / 2).fill(null);
+
+  locales.forEach(l => { rules[l] = create_c_plural_fn(l, 'fn'); });
+
+  const singulars = locales.map(l => data.singularKeys.map(k => data[l].singular[k] || data[base].singular[k] || null));
+  const plurals = locales.map(l => data.pluralKeys.map(k => plural_forms(l, base, data, k)));
+
+  for (let a = 0; a < n; a++) {
+    for (let b = a + 1; b < n; b++) {
+      const bytes = new Array(Math.ceil(keys / 8)).fill(0);
+      let changed = false;
+
+      const mark = i => {
+        // eslint-disable-next-line no-bitwise
+        bytes[Math.floor(i / 8)] |= 1 << (i % 8);
+        changed = true;
+      };
+
+      singulars[a].forEach((str, i) => {
+        if (str !== singulars[b][i]) mark(i);
+      });
+      plurals[a].forEach((forms, i) => {
+        if (!plural_equal(forms, plurals[b][i], rules)) mark(data.singularKeys.length + i);
+      });
+
+      if (!changed) continue;
+
+      const id = bytes.join(',');
+
+      if (!names.has(id)) {
+        const name = `lv_i18n_diff_${bitmaps.length}`;
+
+        names.set(id, name);
+        bitmaps.push({ name, bytes, locales: [ locales[a], locales[b] ] });
+      }
+
+      pairs[pair_index(a, b, n)] = names.get(id);
+    }
+  }
+
+  return { bitmaps, pairs };
+}
+
+
+module.exports.pair_index = pair_index;
+module.exports.create_locale_diff = create_locale_diff;
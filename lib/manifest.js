@@ -0,0 +1,96 @@
+// Manifest of `compile` inputs & outputs (content hashes), to skip work
+// when nothing changed (see `--manifest` option).
+//
+// Format (JSON):
+//
+//   {
+//     "version": "<lv_i18n version>",
+//     "args": { ... },
+//     "inputs": [ [ "<path>", "<hash>" ], ... ],
+//     "outputs": { "<path>": "<hash>", ... }
+//   }
+//
+// Templates are listed in inputs too, for development versions.
+//
+'use strict';
+
+
+const glob = require('glob').sync;
+
+const { createHash } = require('crypto');
+const { join } = require('path');
+const { readFileSync, writeFileSync } = require('fs');
+
+
+const VERSION = require('../package.json').version;
+const TEMPLATES = [ 'lv_i18n.template.c', 'lv_i18n.template.h', 'lv_i18n.template.hpp' ]
+  .map(f => join(__dirname, '../src', f));
+
+
+function hash(content) {
+  return createHash('sha1').update(content).digest('hex');
+}
+
+function hash_file(fileName) {
+  try {
+    return hash(readFileSync(fileName));
+  } catch (__) {
+    return null;
+  }
+}
+
+
+// Collect current state of inputs. Translation & source files are globbed
+// the same way as in `TranslationKeys.loadFiles()`, order matters.
+function create_manifest(args) {
+  let files = [];
+
+  args.translations.forEach(p => files.push(...glob(p, { nodir: true })));
+  (args.sources || []).forEach(p => files.push(...glob(p, { nodir: true })));
+  files.push(...args.sourceref || []);
+  if (args.profile) files.push(args.profile);
+
+  let options = Object.assign({}, args);
+  delete options.manifest;
+
+  return {
+    version: VERSION,
+    args: options,
+    inputs: files.concat(TEMPLATES).map(f => [ f, hash_file(f) ]),
+    outputs: {}
+  };
+}
+
+
+// True if previous manifest has the same inputs, and outputs were not
+// changed or removed since then.
+function is_up_to_date(fileName, manifest) {
+  let prev;
+
+  try {
+    prev = JSON.parse(readFileSync(fileName, 'utf8'));
+  } catch (__) {
+    return false;
+  }
+
+  if (prev.version !== manifest.version ||
+      JSON.stringify(prev.args) !== JSON.stringify(manifest.args) ||
+      JSON.stringify(prev.inputs) !== JSON.stringify(manifest.inputs)) {
+    return false;
+  }
+
+  return Object.entries(prev.outputs || {}).every(([ f, h ]) => hash_file(f) === h);
+}
+
+
+// `outputs` - written files content, `{ path: content }`
+function save_manifest(fileName, manifest, outputs) {
+  Object.entries(outputs).forEach(([ f, content ]) => { manifest.outputs[f] = hash(content); });
+
+  writeFileSync(fileName, JSON.stringify(manifest, null, 2) + '\n');
+}
+
+
+module.exports.create_manifest = create_manifest;
+module.exports.is_up_to_date = is_up_to_date;
+module.exports.save_manifest = save_manifest;
@@ -7,7 +7,20 @@
 
 const defaults = {
   singularName: '_',
-  pluralName: '_p'
+  singularCachedName: '_i',
+  pluralName: '_p',
+  singularCtxName: '_c',
+  pluralCtxName: '_cp',
+  formatName: 'lv_i18n_format',
+  formatPluralName: 'lv_i18n_format_plural',
+  formatCtxName: 'lv_i18n_ctx_format',
+  formatPluralCtxName: 'lv_i18n_ctx_format_plural',
+  // C++ front end, `lv_i18n.hpp`
+  cppSingularName: 'LV_I18N_TR',
+  cppPluralName: 'LV_I18N_TRP',
+  cppTemplateName: 'tr',
+  cppTemplatePluralName: 'trp',
+  cppLiteralSuffix: '_tr'
 };
 
 
@@ -15,16 +28,49 @@ function escape_re(s) {
   return s.replace(/[.*+?^${}()|[\]\\]/g, '\\$&');
 }
 
-function create_singular_re(fn_name) {
-  return new RegExp(
-    '(?:^|[ =+,;\(])' + escape_re(fn_name) + '\\("(.*?)"\\)',
-    'g'
-  );
+// Patterns below are sources for a single combined regexp. Each one has
+// exactly one capture group - the phrase.
+
+function singular_re(fn_name) {
+  return escape_re(fn_name) + '\\("(.*?)"\\)';
 }
 
-function create_plural_re(fn_name) {
+function plural_re(fn_name) {
+  return escape_re(fn_name) + '\\("(.*?)",';
+}
+
+// Context versions, `_c(ctx, "text")`. Context argument is expected to be
+// simple expression, like `&ctx` or `ui->ctx`.
+function singular_ctx_re(fn_name) {
+  return escape_re(fn_name) + '\\([^,()"]*,\\s*"(.*?)"\\)';
+}
+
+function plural_ctx_re(fn_name) {
+  return escape_re(fn_name) + '\\([^,()"]*,\\s*"(.*?)",';
+}
+
+// Format functions, `lv_i18n_format(buf, sizeof(buf), "text", ...)`. Text
+// follows `skip` arguments, expected to be simple expressions without commas.
+function format_re(fn_name, skip) {
+  return escape_re(fn_name) + '\\(' + '[^,"]*,'.repeat(skip) + '\\s*"(.*?)"[,)]';
+}
+
+// C++ templates, `lv_i18n::tr<"text">()`
+function template_re(fn_name) {
+  return escape_re(fn_name) + '<"(.*?)">';
+}
+
+// C++ user-defined literal, `"text"_tr`
+function literal_re(suffix) {
+  return '"((?:[^"\\\\]|\\\\.)*)"' + escape_re(suffix) + '(?![\\w])';
+}
+
+// Join patterns into one regexp, to scan text in a single pass. Prefix is
+// a lookbehind, so that it is not consumed and does not hide a call right
+// after another one (`_p("a", _("b"))`). `:` is for C++ namespaces.
+function create_re(patterns) {
   return new RegExp(
-    '(?:^|[ =+,;\(])' + escape_re(fn_name) + '\\("(.*?)",',
+    '(?<=^|[ =+,;:\\(])(?:' + patterns.map(p => p.re).join('|') + ')',
     'g'
   );
 }
@@ -58,22 +104,32 @@ function unescape_c(src) {
 }
 
 
-function getLine(text, offset) {
-  return text.substring(0, offset).split('\n').length;
-}
-
-
-function extract(text, re) {
+function extract(text, re, patterns) {
   let result = [];
+  let line = 1;
+  let line_start = 0;
 
   for (;;) {
     let match = re.exec(text);
 
     if (!match) break;
 
+    // Count lines incrementally, matches go in order of position
+    for (;;) {
+      let nl = text.indexOf('\n', line_start);
+
+      if (nl < 0 || nl >= match.index) break;
+
+      line++;
+      line_start = nl + 1;
+    }
+
+    let idx = match.findIndex((m, i) => i > 0 && typeof m !== 'undefined');
+
     result.push({
-      key: unescape_c(match[1]),
-      line: getLine(text, match.index)
+      key: unescape_c(match[idx]),
+      line,
+      plural: patterns[idx - 1].plural
     });
   }
 
@@ -84,13 +140,24 @@ function extract(text, re) {
 module.exports = function parse(text, options) {
   let opts = Object.assign({}, defaults, options || {});
 
-  let s_re = create_singular_re(opts.singularName);
-  let p_re = create_plural_re(opts.pluralName);
-
-  let singulars = extract(text, s_re).map(o => Object.assign(o, { plural:  false }));
-  let plurals = extract(text, p_re).map(o => Object.assign(o, { plural:  true }));
-
-  return singulars.concat(plurals).sort((a, b) => a.line - b.line);
+  let patterns = [
+    { re: singular_re(opts.singularName), plural: false },
+    { re: singular_re(opts.singularCachedName), plural: false },
+    { re: plural_re(opts.pluralName), plural: true },
+    { re: singular_ctx_re(opts.singularCtxName), plural: false },
+    { re: plural_ctx_re(opts.pluralCtxName), plural: true },
+    { re: format_re(opts.formatName, 2), plural: false },
+    { re: format_re(opts.formatCtxName, 3), plural: false },
+    { re: format_re(opts.formatPluralName, 2), plural: true },
+    { re: format_re(opts.formatPluralCtxName, 3), plural: true },
+    { re: singular_re(opts.cppSingularName), plural: false },
+    { re: plural_re(opts.cppPluralName), plural: true },
+    { re: template_re(opts.cppTemplateName), plural: false },
+    { re: template_re(opts.cppTemplatePluralName), plural: true },
+    { re: literal_re(opts.cppLiteralSuffix), plural: false }
+  ];
+
+  return extract(text, create_re(patterns), patterns);
 };
 
 module.exports._unescape_c = unescape_c;
@@ -77,6 +77,114 @@ function toSingleRule(str) {
     .replace(/ and /g, ' && ');
 }
 
+// Plural rule bytecode, for binary translation packs. Evaluated by
+// `__lv_i18n_plural_eval()` in C. Integers only (same as C functions),
+// so `n` = `i` = abs(num), and other operands are zero.
+//
+// rule     := forms_count:u8 { form:u8 or_count:u8 { and_count:u8 { relation } } }
+// relation := operand:u8 (bit 7 = negate) mod:u32 ranges_count:u8 { from:u32 to:u32 }
+//
+// All numbers are little-endian. Forms are checked in order, first match
+// wins, `other` if nothing matched.
+//
+const form_codes = { zero: 0, one: 1, two: 2, few: 3, many: 4, other: 5 };
+const operand_codes = { n: 0, i: 1, v: 2, w: 3, f: 4, t: 5, e: 6, c: 6 };
+
+
+function parse_relation(str) {
+  let m = str.trim().match(/^([a-z])(?:\s*%\s*(\d+))?\s*(!=|=)\s*([\d.,]+)$/);
+
+  if (!m || !(m[1] in operand_codes)) throw new Error(`Unsupported plural relation: "${str}"`);
+
+  return {
+    operand: operand_codes[m[1]],
+    mod: Number(m[2] || 0),
+    negate: m[3] === '!=',
+    ranges: m[4].split(',').map(r => r.split('..').map(Number)).map(r => [ r[0], r[r.length - 1] ])
+  };
+}
+
+
+function u32(val) {
+  const buf = Buffer.alloc(4);
+  buf.writeUInt32LE(val);
+  return [ ...buf ];
+}
+
+
+function create_plural_bytecode(locale) {
+  let cldr_rules = renameKeys(cardinals[locale.toLowerCase().split(/[-_]/)[0]]);
+  let forms = Object.entries(cldr_rules).filter(([ form ]) => form !== 'other');
+  let code = [ forms.length ];
+
+  forms.forEach(([ form, rule ]) => {
+    let groups = rule.split('@')[0].trim().split(' or ').map(g => g.split(' and ').map(parse_relation));
+
+    code.push(form_codes[form], groups.length);
+
+    groups.forEach(relations => {
+      code.push(relations.length);
+
+      relations.forEach(r => {
+        // eslint-disable-next-line no-bitwise
+        code.push(r.operand | (r.negate ? 0x80 : 0), ...u32(r.mod), r.ranges.length);
+        r.ranges.forEach(([ from, to ]) => code.push(...u32(from), ...u32(to)));
+      });
+    });
+  });
+
+  return Buffer.from(code);
+}
+
+
+// Reference implementation of C interpreter, for tests & rule matching
+function eval_plural_bytecode(code, num) {
+  let n = Math.abs(num);
+  let pos = 0;
+  let forms = code[pos++];
+
+  for (; forms > 0; forms--) {
+    let form = code[pos++];
+    let match = false;
+
+    for (let ors = code[pos++]; ors > 0; ors--) {
+      let group = true;
+
+      for (let ands = code[pos++]; ands > 0; ands--) {
+        let op = code[pos];
+        let mod = code.readUInt32LE(pos + 1);
+        let ranges = code[pos + 5];
+        // eslint-disable-next-line no-bitwise
+        let val = (op & 0x7F) <= operand_codes.i ? n : 0;
+        let rel = false;
+
+        pos += 6;
+        if (mod) val %= mod;
+
+        for (; ranges > 0; ranges--, pos += 8) {
+          if (code.readUInt32LE(pos) <= val && val <= code.readUInt32LE(pos + 4)) rel = true;
+        }
+
+        // eslint-disable-next-line no-bitwise
+        if (op & 0x80) rel = !rel;
+        group = group && rel;
+      }
+
+      match = match || group;
+    }
+
+    if (match) return form;
+  }
+
+  return form_codes.other;
+}
+
+
+module.exports.form_codes = form_codes;
+module.exports.create_plural_bytecode = create_plural_bytecode;
+module.exports.eval_plural_bytecode = eval_plural_bytecode;
+
+
 module.exports.create_c_plural_fn = function (locale, fn_name) {
   let cldr_rules = renameKeys(cardinals[locale.toLowerCase().split('-')[0]]);
 
@@ -0,0 +1,85 @@
+// Hot / cold placement of translations, for `--profile` option. Strings of
+// phrases, used in profiled run, go to `LV_I18N_HOT_SECTION` pool, the rest
+// to `LV_I18N_COLD_SECTION` pool, one pair of pools per locale. Tables keep
+// pointers, so lookup is the same.
+//
+// Profile is a text file, line by line:
+//
+// - `lv_i18n_stats_dump()` output of `LV_I18N_STATS` build. Phrases with
+//   hits or fallbacks are hot. Other lines of dump are skipped.
+// - Or plain list of hot phrases, one per line.
+//
+'use strict';
+
+
+const { create_string_pool } = require('./string_pool');
+
+
+const DUMP_PHRASE_RE = /^(singular|plural) "(.*)": hits (\d+), fallbacks (\d+), misses \d+, time \d+$/;
+// Locales, totals, and phrase lines, truncated by dump buffer
+const DUMP_OTHER_RE = /^(locale|singular|plural) "|^unknown phrases: \d+$/;
+
+
+// `{ singular: Set, plural: Set, skipped }`, where `skipped` is count of
+// dump lines, not recognized (truncated)
+function parse_profile(text) {
+  const result = { singular: new Set(), plural: new Set(), skipped: 0 };
+
+  text.split(/\r?\n/).forEach(line => {
+    if (!line) return;
+
+    const m = DUMP_PHRASE_RE.exec(line);
+
+    if (m) {
+      if (Number(m[3]) + Number(m[4]) > 0) result[m[1]].add(m[2]);
+      return;
+    }
+
+    if (DUMP_OTHER_RE.test(line)) {
+      if (!/^(locale "|unknown phrases)/.test(line)) result.skipped++;
+      return;
+    }
+
+    // Plain list, phrase kind is not known
+    result.singular.add(line);
+    result.plural.add(line);
+  });
+
+  return result;
+}
+
+
+// `{ hot: { singular, plural }, locales: { "en-GB": { hot, cold } } }`,
+// where `hot` & `cold` are string pools (see `lib/string_pool.js`). String,
+// used by both hot & cold phrases, is hot.
+function create_placement(locales, data, profile) {
+  const hot = {
+    singular: new Set(data.singularKeys.filter(k => profile.singular.has(k))),
+    plural: new Set(data.pluralKeys.filter(k => profile.plural.has(k)))
+  };
+  const result = { hot, locales: {} };
+
+  locales.forEach(l => {
+    const strings = { hot: [], cold: [] };
+
+    data.singularKeys.forEach(k => {
+      strings[hot.singular.has(k) ? 'hot' : 'cold'].push(data[l].singular[k]);
+    });
+    Object.values(data[l].plural).forEach(form => data.pluralKeys.forEach(k => {
+      strings[hot.plural.has(k) ? 'hot' : 'cold'].push(form[k]);
+    }));
+
+    const hot_pool = create_string_pool(strings.hot);
+
+    result.locales[l] = {
+      hot: hot_pool,
+      cold: create_string_pool(strings.cold.filter(str => !hot_pool.offset(str)))
+    };
+  });
+
+  return result;
+}
+
+
+module.exports.parse_profile = parse_profile;
+module.exports.create_placement = create_placement;
@@ -0,0 +1,49 @@
+// Dead phrases elimination, for `-s` / `--sourceref` options of `compile`.
+// Only phrases, referenced by sources, are compiled, so each build variant
+// carries the minimal set.
+//
+// Phrases, which are not string literals in sources (`_(name)` with
+// variable), are not visible here. Reference those somewhere as literals.
+//
+'use strict';
+
+
+// Remove phrases, missed in `used` set, from `data`. Returns report
+// `{ keys: [ key ], locales: { "en-GB": { strings, bytes } } }`.
+function prune_keys(locales, data, used) {
+  const dead = k => !used.has(k);
+  const dead_singulars = data.singularKeys.filter(dead);
+  const dead_plurals = data.pluralKeys.filter(dead);
+  const report = { keys: dead_singulars.concat(dead_plurals), locales: {} };
+
+  locales.forEach(l => {
+    let strings = 0;
+    let bytes = 0;
+
+    const remove = (obj, k) => {
+      if (obj[k]) {
+        strings++;
+        bytes += Buffer.byteLength(obj[k]) + 1;
+      }
+      delete obj[k];
+    };
+
+    dead_singulars.forEach(k => remove(data[l].singular, k));
+
+    Object.entries(data[l].plural).forEach(([ form, strs ]) => {
+      dead_plurals.forEach(k => remove(strs, k));
+
+      if (!Object.keys(strs).length) delete data[l].plural[form];
+    });
+
+    report.locales[l] = { strings, bytes };
+  });
+
+  data.singularKeys = data.singularKeys.filter(k => !dead(k));
+  data.pluralKeys = data.pluralKeys.filter(k => !dead(k));
+
+  return report;
+}
+
+
+module.exports.prune_keys = prune_keys;
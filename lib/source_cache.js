@@ -0,0 +1,114 @@
+// Persistent cache of parsed source files, to skip unchanged ones on next
+// `extract` run.
+//
+// File is checked by mtime & size first (no read at all), then by content
+// hash (file touched, but not changed). Format (JSON):
+//
+//   {
+//     "version": "<format>:<lv_i18n version>",
+//     "keys": [ "<key>", ... ],
+//     "files": {
+//       "<path>": [ mtime, size, hash, [ key_ref, line, key_ref, line, ... ] ],
+//       ...
+//     }
+//   }
+//
+// Keys are repeated in many files, so those are stored once. `key_ref` is
+// `key_index * 2 + plural`. Cache is dropped on version mismatch, so parser
+// changes are safe.
+//
+'use strict';
+
+
+const debug = require('debug')('source_cache');
+
+const { readFileSync, writeFileSync } = require('fs');
+
+
+const FORMAT = 1;
+const VERSION = `${FORMAT}:${require('../package.json').version}`;
+
+
+module.exports = class SourceCache {
+  constructor(fileName) {
+    this.fileName = fileName;
+    this.keys = [];
+    this.files = {};
+    // Entries of this run, others (removed files) are dropped on save.
+    this.used = {};
+    this.changed = false;
+
+    let data;
+
+    try {
+      data = JSON.parse(readFileSync(fileName, 'utf8'));
+    } catch (__) {
+      debug(`No cache at ${fileName}`);
+      return;
+    }
+
+    if (data.version !== VERSION) {
+      debug(`Cache version mismatch (${data.version}), ignored`);
+      return;
+    }
+
+    this.keys = data.keys;
+    this.files = data.files;
+  }
+
+  decode(refs) {
+    let result = [];
+
+    for (let i = 0; i < refs.length; i += 2) {
+      result.push([ this.keys[refs[i] >> 1], refs[i + 1], refs[i] & 1 ]);
+    }
+
+    return result;
+  }
+
+  // Returns `{ fresh, hash, keys }` or `null` if no entry. Not fresh entry
+  // can be reused when content hash is the same.
+  get(name, stat) {
+    let entry = this.files[name];
+
+    if (!entry) return null;
+
+    let [ mtime, size, hash, refs ] = entry;
+    let fresh = mtime === stat.mtimeMs && size === stat.size;
+    let keys = this.decode(refs);
+
+    if (fresh) this.used[name] = [ mtime, size, hash, keys ];
+
+    return { fresh, hash, keys };
+  }
+
+  set(name, stat, hash, keys) {
+    this.used[name] = [ stat.mtimeMs, stat.size, hash, keys ];
+    this.changed = true;
+  }
+
+  save() {
+    if (!this.changed && Object.keys(this.used).length === Object.keys(this.files).length) return;
+
+    let keys = [];
+    let key_ids = new Map();
+    let files = {};
+
+    Object.entries(this.used).forEach(([ name, [ mtime, size, hash, file_keys ] ]) => {
+      let refs = [];
+
+      file_keys.forEach(([ key, line, plural ]) => {
+        if (!key_ids.has(key)) {
+          key_ids.set(key, keys.length);
+          keys.push(key);
+        }
+
+        refs.push(key_ids.get(key) * 2 + (plural ? 1 : 0), line);
+      });
+
+      files[name] = [ mtime, size, hash, refs ];
+    });
+
+    writeFileSync(this.fileName, JSON.stringify({ version: VERSION, keys, files }));
+  }
+};
@@ -3,23 +3,35 @@
 'use strict';
 
 
-const glob      = require('glob').sync;
-const debug     = require('debug')('sourcee_keys');
-const AppError  = require('./app_error');
-const parse     = require('./parser');
+const glob        = require('glob').sync;
+const debug       = require('debug')('sourcee_keys');
+const AppError    = require('./app_error');
+const parse       = require('./parser');
+const SourceCache = require('./source_cache');
 
-const { readFileSync, writeFileSync } = require('fs');
+const { readFileSync, writeFileSync, statSync } = require('fs');
+const { cpus } = require('os');
+const { parseFiles } = require('./source_worker');
 
 
 module.exports = class SourceKeys {
-  constructor() {
+  // Options:
+  //
+  // - conflicts - fail on key, used as both singular and plural (default: true)
+  //
+  constructor(options = {}) {
     this.filesCount = 0;
 
+    this.checkConflicts = options.conflicts !== false;
+
     this.keys = [];
 
     // Used to check conflicts, when key is used as both singular and plural
     // Contain first entry of key.
     this.uniques = {};
+
+    // All entries of each key, in order of appearance
+    this.occurrences = new Map();
   }
 
   addKey(obj) {
@@ -27,7 +39,7 @@ module.exports = class SourceKeys {
 
     if (!this.uniques.hasOwnProperty(key)) {
       this.uniques[key] = obj;
-    } else if (this.uniques[key].plural !== plural) {
+    } else if (this.checkConflicts && this.uniques[key].plural !== plural) {
       throw new AppError (`
 Conflicting key '${key}' - should not be used as singular and plural at once.
 
@@ -39,6 +51,9 @@ ${this.uniques[key].fileName}, line ${this.uniques[key].line}
     }
 
     this.keys.push(obj);
+
+    if (!this.occurrences.has(key)) this.occurrences.set(key, []);
+    this.occurrences.get(key).push(obj);
   }
 
   // convenient for testing, to inline content
@@ -52,25 +67,59 @@ ${this.uniques[key].fileName}, line ${this.uniques[key].line}
     this.filesCount++;
   }
 
+  // Keys in compact form `[ key, line, plural ]`, from cache or worker
+  loadParsed(keys, fileName) {
+    debug(`Load: ${fileName}`);
+
+    keys.forEach(([ key, line, plural ]) => this.addKey({ key, line, plural: !!plural, fileName }));
+
+    this.filesCount++;
+  }
+
   loadFile(name) {
     this.loadText(readFileSync(name, 'utf8'), name);
   }
 
-  loadFiles(paths) {
+  // Options:
+  //
+  // - cache - cache file name, to skip unchanged sources
+  // - jobs - max number of parallel workers (default: CPU count)
+  //
+  loadFiles(paths, options = {}) {
+    let cache = options.cache ? new SourceCache(options.cache) : null;
+    let files = [];
+
     paths.forEach(p => {
-      glob(p, { nodir: true }).forEach(name => this.loadFile(name));
+      glob(p, { nodir: true }).forEach(name => {
+        let stat = cache ? statSync(name) : null;
+
+        files.push({ name, stat, cached: cache ? cache.get(name, stat) : null });
+      });
     });
+
+    let stale = files.filter(f => !f.cached || !f.cached.fresh);
+    let parsed = parseFiles(
+      stale.map(f => ({ name: f.name, hash: f.cached && f.cached.hash })),
+      options.jobs || cpus().length
+    );
+
+    stale.forEach((f, i) => {
+      // Keys are omitted if content is not changed
+      f.keys = parsed[i].keys || f.cached.keys;
+
+      if (cache) cache.set(f.name, f.stat, parsed[i].hash, f.keys);
+    });
+
+    files.forEach(f => this.loadParsed(f.keys || f.cached.keys, f.name));
+
+    if (cache) cache.save();
   }
 
   dumpSourceRef(filename) {
     let result = [];
 
-    Object.values(this.uniques).forEach(k1 => {
-      Object.values(this.keys).forEach(k2 => {
-        if (k1.key === k2.key) {
-          result.push(k2);
-        }
-      });
+    Object.values(this.uniques).forEach(k => {
+      result.push(...this.occurrences.get(k.key));
     });
 
     writeFileSync(filename, JSON.stringify(result, null, 2));
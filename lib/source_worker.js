@@ -0,0 +1,109 @@
+// Parse source files, in parallel worker threads for big amounts.
+//
+// Keys are returned in compact form, `[ key, line, plural ]`, the same as
+// stored in cache.
+//
+'use strict';
+
+
+const parse = require('./parser');
+
+const { createHash } = require('crypto');
+const { readFileSync } = require('fs');
+const { Worker, MessageChannel, receiveMessageOnPort, isMainThread, workerData } = require('worker_threads');
+
+
+// Don't spawn workers for less files, startup is not free
+const MIN_FILES_PER_JOB = 200;
+
+
+function hash(text) {
+  return createHash('sha1').update(text).digest('base64').slice(0, 27);
+}
+
+
+// Returns `{ hash, keys }`. If content hash equals to `known_hash`, file is
+// not parsed and `keys` are omitted.
+function parseFile(name, known_hash) {
+  let text = readFileSync(name, 'utf8');
+  let h = hash(text);
+
+  if (h === known_hash) return { hash: h };
+
+  return { hash: h, keys: parse(text).map(k => [ k.key, k.line, k.plural ? 1 : 0 ]) };
+}
+
+
+// Parse list of `{ name, hash }`, results are in the same order. Blocks
+// until all workers finish, to keep CLI synchronous.
+function parseFiles(files, jobs) {
+  jobs = Math.min(jobs, Math.floor(files.length / MIN_FILES_PER_JOB));
+
+  if (jobs <= 1) return files.map(f => parseFile(f.name, f.hash));
+
+  let done = new Int32Array(new SharedArrayBuffer(4));
+  let chunk_size = Math.ceil(files.length / jobs);
+  let workers = [];
+
+  for (let i = 0; i < jobs; i++) {
+    let { port1, port2 } = new MessageChannel();
+    let worker = new Worker(__filename, {
+      workerData: { files: files.slice(i * chunk_size, (i + 1) * chunk_size), port: port2, done },
+      transferList: [ port2 ]
+    });
+
+    // Failures are reported via port, and event loop is blocked anyway
+    worker.on('error', () => {});
+    worker.unref();
+    workers.push({ worker, port: port1 });
+  }
+
+  for (let n; (n = Atomics.load(done, 0)) < jobs;) Atomics.wait(done, 0, n);
+
+  let result = [];
+  let error = null;
+
+  workers.forEach(({ worker, port }) => {
+    let received = receiveMessageOnPort(port);
+    let msg = received ? received.message : { error: 'Source parser worker stopped without result' };
+
+    port.close();
+    worker.terminate();
+
+    if (msg.error) error = error || msg.error;
+    else result = result.concat(msg.files);
+  });
+
+  if (error) throw new Error(error);
+
+  return result;
+}
+
+
+if (!isMainThread && workerData && workerData.done) {
+  let { files, port, done } = workerData;
+  let reported = false;
+
+  const report = msg => {
+    if (reported) return;
+
+    port.postMessage(msg);
+    reported = true;
+    Atomics.add(done, 0, 1);
+    Atomics.notify(done, 0);
+  };
+
+  // Main thread waits for all jobs, count this one on any exit (uncaught
+  // error, `process.exit()`), not only on normal finish
+  process.on('exit', code => report({ error: `Source parser worker exited with code ${code}` }));
+
+  try {
+    report({ files: files.map(f => parseFile(f.name, f.hash)) });
+  } catch (e) {
+    report({ error: e.message });
+  }
+}
+
+
+module.exports.parseFile = parseFile;
+module.exports.parseFiles = parseFiles;
@@ -0,0 +1,54 @@
+// String pool for `--string-pool` mode. All translations are stored in
+// a single blob, referenced by offsets instead of pointers. Equal strings
+// are stored once, and strings which are suffixes of others share bytes
+// with them ("Cancel" contains "el").
+//
+// Offset 0 is reserved for NULL, pool always starts with '\0'.
+//
+'use strict';
+
+
+function create_string_pool(strings) {
+  const list = [ ...new Set(strings.filter(Boolean)) ].map(str => {
+    const bytes = Buffer.from(str, 'utf8');
+    return { str, bytes, rev: Buffer.from(bytes).reverse(), owner: null, offset: 0 };
+  });
+
+  // After sort by reversed bytes, all strings ending with X follow X.
+  // So it's enough to check neighbour to find the longest one to share.
+  const sorted = list.slice().sort((a, b) => Buffer.compare(a.rev, b.rev));
+
+  for (let i = sorted.length - 1; i >= 0; i--) {
+    const e = sorted[i];
+    const next = sorted[i + 1];
+
+    e.owner = next && next.rev.subarray(0, e.rev.length).equals(e.rev) ? next.owner : e;
+  }
+
+  // Place strings in original order, to keep output readable & stable
+  const entries = [];
+  let size = 1;
+
+  list.filter(e => e.owner === e).forEach(e => {
+    e.offset = size;
+    size += e.bytes.length + 1;
+    entries.push({ str: e.str, offset: e.offset });
+  });
+
+  const offsets = new Map();
+
+  list.forEach(e => {
+    offsets.set(e.str, e.owner.offset + e.owner.bytes.length - e.bytes.length);
+  });
+
+  return {
+    size,
+    offset_type: size <= 0xFFFF ? 'uint16_t' : 'uint32_t',
+    entries,
+    // Offset of string in pool, 0 for NULL / empty
+    offset: str => (str ? offsets.get(str) : 0)
+  };
+}
+
+
+module.exports.create_string_pool = create_string_pool;
@@ -20,6 +20,10 @@ function normalize_locale(l) {
   return l.toLowerCase().replace(/_/g, '-');
 }
 
+function phrase_id(locale, key) {
+  return `${locale}\0${key}`;
+}
+
 
 module.exports = class TranslationKeys {
   constructor() {
@@ -29,6 +33,8 @@ module.exports = class TranslationKeys {
     this.localeDefaultFile = {};
 
     this.phrases = [];
+    // First phrase for locale + key, for fast lookup
+    this.index = new Map();
   }
 
   addPhrase(obj) {
@@ -65,20 +71,41 @@ Bad plural value for '${k}' in '${key}', should be string or null ('~')
       });
     }
 
-    this.phrases.push({
+    let phrase = {
       locale,
       key,
       value,
       fileName
-    });
+    };
+
+    this.phrases.push(phrase);
+
+    let id = phrase_id(locale, key);
+    if (!this.index.has(id)) this.index.set(id, phrase);
   }
 
   getPhraseObj(locale, key) {
-    return this.phrases.find(p => p.locale === locale && p.key === key);
+    return this.index.get(phrase_id(locale, key));
   }
 
   removePhraseObj(locale, key) {
     this.phrases = this.phrases.filter(p => !(p.locale === locale && p.key === key));
+    this.index.delete(phrase_id(locale, key));
+  }
+
+  // Rename key in locale, existing phrase with new key is dropped
+  renamePhraseObj(locale, from, to) {
+    let obj = this.getPhraseObj(locale, from);
+
+    if (!obj) return null;
+
+    this.removePhraseObj(locale, to);
+    this.index.delete(phrase_id(locale, from));
+
+    obj.key = to;
+    this.index.set(phrase_id(locale, to), obj);
+
+    return obj;
   }
 
   // convenient for testing, to inline content
@@ -1,8 +1,70 @@
 #include "./lv_i18n.h"
+#include <stdarg.h>
+
+// Locale pointers are loaded & stored atomically, to allow locale switch
+// while other threads get translations. Override for compilers without
+// GCC builtins, if plain volatile access is not atomic on your platform.
+#ifndef LV_I18N_ATOMIC_LOAD
+#if defined(__GNUC__)
+#define LV_I18N_ATOMIC_LOAD(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define LV_I18N_ATOMIC_STORE(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+#else
+#define LV_I18N_ATOMIC_LOAD(ptr) (*(ptr))
+#define LV_I18N_ATOMIC_STORE(ptr, val) (*(ptr) = (val))
+#endif
+#endif
+
+// Atomic increment, returns new value. Concurrent increments must give
+// different values, override together with the above.
+#ifndef LV_I18N_ATOMIC_INC
+#if defined(__GNUC__)
+#define LV_I18N_ATOMIC_INC(ptr) __atomic_add_fetch(ptr, 1, __ATOMIC_ACQ_REL)
+#else
+#define LV_I18N_ATOMIC_INC(ptr) (++*(ptr))
+#endif
+#endif
+
+// Used by `lv_i18n_format()` for non-trivial specs
+#ifndef LV_I18N_SNPRINTF
+#include <stdio.h>
+#define LV_I18N_SNPRINTF snprintf
+#endif
+
+// Default context, used by functions without `ctx` argument
+static lv_i18n_ctx_t default_ctx;
+
+#ifndef LV_I18N_COMPRESS
+// Locale generation of default context, for `_i()` call site caches. Never
+// zero, so empty cache entry does not match.
+volatile uintptr_t lv_i18n_generation = 1;
+#endif
+
+// Invalidate `_i()` caches, after locale switch of default context
+static void __lv_i18n_ctx_invalidate(const lv_i18n_ctx_t * ctx)
+{
+#ifndef LV_I18N_COMPRESS
+    if(ctx != &default_ctx) return;
+
+    // Concurrent switches get own generations, zero is skipped on wrap
+    while(LV_I18N_ATOMIC_INC(&lv_i18n_generation) == 0) {}
+#else
+    (void)ctx;
+#endif
+}
+
+// Locale change subscribers, see `lv_i18n_add_locale_change_cb()`
+#ifndef LV_I18N_LOCALE_CHANGE_CB_MAX
+#define LV_I18N_LOCALE_CHANGE_CB_MAX 4
+#endif
 
-// Internal state
-static const lv_i18n_language_pack_t * current_lang_pack;
-static const lv_i18n_lang_t * current_lang;
+typedef struct {
+    lv_i18n_locale_change_cb_t cb;
+    void * user_data;
+} __lv_i18n_change_sub_t;
+
+static __lv_i18n_change_sub_t change_subs[LV_I18N_LOCALE_CHANGE_CB_MAX];
+
+static void __lv_i18n_ctx_notify(const lv_i18n_ctx_t * ctx, const char * old_locale, const lv_i18n_lang_t * old_lang);
 
 /*SAMPLE_START*/
 
@@ -24,9 +86,10 @@ static inline uint32_t op_t(uint32_t val) { UNUSED(val); return 0; }
 static inline uint32_t op_e(uint32_t val) { UNUSED(val); return 0; }
 
 static const char * en_gb_singulars[] = {
-  "english only", // 0="s_en_only"
-  "s translated", // 1="s_translated"
-  NULL, // 2="s_untranslated"
+  "Dogs of %s: %d", // 0="s_dogs_of"
+  "english only", // 1="s_en_only"
+  "s translated", // 2="s_translated"
+  NULL, // 3="s_untranslated"
 };
 
 static const char * en_gb_plurals_one[] = {
@@ -56,9 +119,10 @@ static const lv_i18n_lang_t en_gb_lang = {
 };
 
 static const char * ru_ru_singulars[] = {
-  NULL, // 0="s_en_only"
-  "s переведено", // 1="s_translated"
-  NULL, // 2="s_untranslated"
+  "%2$d собакенов у %1$s", // 0="s_dogs_of"
+  NULL, // 1="s_en_only"
+  "s переведено", // 2="s_translated"
+  NULL, // 3="s_untranslated"
 };
 
 static const char * ru_ru_plurals_one[] = {
@@ -95,21 +159,9 @@ static const lv_i18n_lang_t ru_ru_lang = {
     .locale_plural_fn = ru_ru_plural_fn
 };
 
-static uint8_t de_de_plural_fn(int32_t num)
-{
-    uint32_t n = op_n(num); UNUSED(n);
-    uint32_t i = op_i(n); UNUSED(i);
-    uint32_t v = op_v(n); UNUSED(v);
-
-    if ((i == 1 && v == 0)) return LV_I18N_PLURAL_TYPE_ONE;
-    return LV_I18N_PLURAL_TYPE_OTHER;
-}
-
 static const lv_i18n_lang_t de_de_lang = {
     .locale_name = "de-DE",
-
-
-    .locale_plural_fn = de_de_plural_fn
+    .locale_plural_fn = en_gb_plural_fn
 };
 
 const lv_i18n_language_pack_t lv_i18n_language_pack[] = {
@@ -119,18 +171,57 @@ const lv_i18n_language_pack_t lv_i18n_language_pack[] = {
     NULL // End mark
 };
 
-#ifndef LV_I18N_OPTIMIZE
+// Language pack indexes, sorted by canonical locale name (binary search)
+static const uint16_t lv_i18n_locale_order[] = {
+    2, // de-de
+    0, // en-gb
+    1, // ru-ru
+};
+
+
+
+
+
+#if !defined(LV_I18N_OPTIMIZE) || defined(LV_I18N_STATS)
 
 static const char * singular_idx[] = {
-"s_en_only",
-"s_translated",
-"s_untranslated",
+    "s_dogs_of",
+    "s_en_only",
+    "s_translated",
+    "s_untranslated",
 
 };
 
 static const char * plural_idx[] = {
-"p_i_have_dogs",
+    "p_i_have_dogs",
+
+};
+
+#endif
+
+#if !defined(LV_I18N_OPTIMIZE) && !defined(LV_I18N_LINEAR_LOOKUP)
+
+static const uint32_t singular_hash_seed = 0;
+
+static const int32_t singular_hash_disp[] = {
+    19,
+};
 
+static const uint16_t singular_hash_slots[] = {
+    1,
+    2,
+    0,
+    3,
+};
+
+static const uint32_t plural_hash_seed = 0;
+
+static const int32_t plural_hash_disp[] = {
+    -1,
+};
+
+static const uint16_t plural_hash_slots[] = {
+    0,
 };
 
 #endif
@@ -138,162 +229,2187 @@ static const char * plural_idx[] = {
 
 /*SAMPLE_END*/
 
-/**
- * Get the translation from a message ID
- * @param msg_id message ID
- * @param msg_index the index of the msg_id
- * @return the translation of `msg_id` on the set local
- */
-const char * lv_i18n_get_singular_by_idx(const char *msg_id, int msg_index)
-{
-    if(current_lang == NULL || msg_index == LV_I18N_ID_NOT_FOUND) return msg_id;
+#ifdef LV_I18N_SPLIT
+// Locales are linked separately and registered in runtime (NULL if not)
+#define LV_I18N_COMPILED_LANG(id) (lv_i18n_registry[id])
+#define LV_I18N_COMPILED_NAME(id) (lv_i18n_locale_names[id])
+#else
+#define LV_I18N_COMPILED_LANG(id) (lv_i18n_language_pack[id])
+#define LV_I18N_COMPILED_NAME(id) (lv_i18n_language_pack[id]->locale_name)
+#endif
 
-    const lv_i18n_lang_t * lang = current_lang;
-    const char * txt;
+#ifdef LV_I18N_COMPRESS
+////////////////////////////////////////////////////////////////////////////////
+// Compressed strings (`--compress` option). Each string is a sequence of
+// byte pair codes, decoded alone into LRU cache of calling thread on lookup.
 
-    // Search in current locale
-    if(lang->singulars != NULL) {
-        txt = lang->singulars[msg_index];
-        if (txt != NULL) return txt;
-    }
+// Max nesting of pairs + 1, must be in sync with `MAX_DEPTH` in `lib/compress.js`
+#define LV_I18N_DECODE_DEPTH 16
 
-    // Try to fallback
-    if(lang == current_lang_pack[0]) return msg_id;
-    lang = current_lang_pack[0];
+// Decoded strings stay valid until that many other strings are decoded
+#ifndef LV_I18N_DECODE_CACHE_SIZE
+#define LV_I18N_DECODE_CACHE_SIZE 8
+#endif
 
-    // Repeat search for default locale
-    if(lang->singulars != NULL) {
-        txt = lang->singulars[msg_index];
-        if (txt != NULL) return txt;
+// `lv_i18n_format()` may decode base locale translation of a phrase
+#if LV_I18N_DECODE_CACHE_SIZE < 2
+#error "LV_I18N_DECODE_CACHE_SIZE must be at least 2"
+#endif
+
+// Decode cache is per thread, so lookups may run in parallel. Define empty
+// if they never do, or to the thread-local keyword of your compiler.
+#ifndef LV_I18N_THREAD_LOCAL
+#if defined(__GNUC__) && (defined(__linux__) || defined(__APPLE__) || defined(__unix__) || defined(_WIN32))
+#define LV_I18N_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define LV_I18N_THREAD_LOCAL __declspec(thread)
+#else
+#error "Define LV_I18N_THREAD_LOCAL for --compress (empty if lookups never run in parallel threads)"
+#endif
+#endif
+
+typedef struct {
+    const char * src;   // compressed string, NULL for empty slot
+    uint32_t used;      // time of last use, for LRU
+    char str[LV_I18N_DECODE_SIZE];
+} __lv_i18n_decoded_t;
+
+static LV_I18N_THREAD_LOCAL __lv_i18n_decoded_t decode_cache[LV_I18N_DECODE_CACHE_SIZE];
+static LV_I18N_THREAD_LOCAL uint32_t decode_time;
+
+// Expand codes of compressed string to `dst`, of LV_I18N_DECODE_SIZE size
+static void __lv_i18n_decode(const char * src, char * dst)
+{
+    uint8_t stack[LV_I18N_DECODE_DEPTH];
+    const uint8_t * p = (const uint8_t *)src;
+    uint32_t sp;
+
+    while(*p != 0) {
+        stack[0] = *p++;
+        sp = 1;
+
+        while(sp > 0) {
+            uint8_t code = stack[--sp];
+
+            if(lv_i18n_codebook[code][0] == 0) {
+                *dst++ = (char)code;
+            }
+            else {
+                stack[sp++] = lv_i18n_codebook[code][1];
+                stack[sp++] = lv_i18n_codebook[code][0];
+            }
+        }
     }
 
-    return msg_id;
+    *dst = '\0';
 }
 
-/**
- * Get the translation from a message ID and apply the language's plural rule to get correct form
- * @param msg_id message ID
- * @param msg_index the index of the msg_id
- * @param num an integer to select the correct plural form
- * @return the translation of `msg_id` on the set local
- */
-const char * lv_i18n_get_plural_by_idx(const char * msg_id, int msg_index, int32_t num)
+// Decoded string from cache, decode into the least recently used slot on miss
+static const char * __lv_i18n_unpack(const char * src)
 {
-    if(current_lang == NULL || msg_index == LV_I18N_ID_NOT_FOUND) return msg_id;
+    __lv_i18n_decoded_t * lru = &decode_cache[0];
+    uint32_t i;
 
-    const lv_i18n_lang_t * lang = current_lang;
-    const char * txt;
-    lv_i18n_plural_type_t ptype;
+    decode_time++;
 
-    // Search in current locale
-    if(lang->locale_plural_fn != NULL) {
-        ptype = lang->locale_plural_fn(num);
+    for(i = 0; i < LV_I18N_DECODE_CACHE_SIZE; i++) {
+        __lv_i18n_decoded_t * slot = &decode_cache[i];
 
-        if(lang->plurals[ptype] != NULL) {
-            txt = lang->plurals[ptype][msg_index];
-            if (txt != NULL) return txt;
+        if(slot->src == src) {
+            slot->used = decode_time;
+            return slot->str;
         }
+
+        // Wrap-safe, the oldest slot has the biggest age
+        if(decode_time - slot->used > decode_time - lru->used) lru = slot;
     }
 
-    // Try to fallback
-    if(lang == current_lang_pack[0]) return msg_id;
-    lang = current_lang_pack[0];
+    __lv_i18n_decode(src, lru->str);
+    lru->src = src;
+    lru->used = decode_time;
+    return lru->str;
+}
 
-    // Repeat search for default locale
-    if(lang->locale_plural_fn != NULL) {
-        ptype = lang->locale_plural_fn(num);
+#define LV_I18N_STR(lang, entry) ((lang)->entry ? __lv_i18n_unpack((lang)->pool + (lang)->entry) : NULL)
+#elif defined(LV_I18N_STRING_POOL)
+#define LV_I18N_STR(lang, entry) ((lang)->entry ? (lang)->pool + (lang)->entry : NULL)
+#else
+#define LV_I18N_STR(lang, entry) ((lang)->entry)
+#endif
+
+// Lookup result details, for formatting & statistics
+typedef struct {
+    const lv_i18n_fmt_token_t * fmt;    // pre-parsed format, if exists
+    uint8_t kind;                       // LV_I18N_STATS_HIT / _FALLBACK / _MISS
+    const lv_i18n_str_info_t * info;    // precomputed metadata, if exists
+} __lv_i18n_found_t;
+
+#define LV_I18N_STATS_HIT 0
+#define LV_I18N_STATS_FALLBACK 1
+#define LV_I18N_STATS_MISS 2
+
+#ifdef LV_I18N_STATS
+#define LV_I18N_FOUND_KIND(found, k) do { if((found) != NULL) (found)->kind = (k); } while(0)
+#else
+#define LV_I18N_FOUND_KIND(found, k) ((void)(found), (void)(k))
+#endif
+
+#ifdef LV_I18N_FORMAT_TOKENS
+#define LV_I18N_FOUND_FMT(found, table, idx) do { if((found) != NULL && (table) != NULL) (found)->fmt = (table)[idx]; } while(0)
+#else
+#define LV_I18N_FOUND_FMT(found, table, idx) (void)(found)
+#endif
+
+#ifdef LV_I18N_STRING_INFO
+#define LV_I18N_FOUND_INFO(found, table, idx) do { \
+        if((found) != NULL && (table) != NULL) (found)->info = &(table)[idx]; \
+    } while(0)
+#else
+#define LV_I18N_FOUND_INFO(found, table, idx) (void)(found)
+#endif
+
+// Report found translation: `k` kind, pre-parsed format from `fmts` and
+// metadata from `infos` tables
+#define LV_I18N_FOUND(found, k, fmts, infos, idx) do { \
+        LV_I18N_FOUND_KIND(found, k); \
+        LV_I18N_FOUND_FMT(found, fmts, idx); \
+        LV_I18N_FOUND_INFO(found, infos, idx); \
+    } while(0)
+
+#if defined(LV_I18N_BINARY) || defined(LV_I18N_PLURAL_TABLE)
+// Little-endian numbers, read byte-wise (data may be unaligned)
+
+static uint32_t __lv_i18n_rd32(const uint8_t * p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
 
-        if(lang->plurals[ptype] != NULL) {
-            txt = lang->plurals[ptype][msg_index];
-            if (txt != NULL) return txt;
+/**
+ * Evaluate plural rule bytecode (see `create_plural_bytecode()` in `lib/plurals.js`).
+ * Stops safely at `end`, if bytecode is broken.
+ */
+static uint8_t __lv_i18n_plural_eval(const uint8_t * p, const uint8_t * end, int32_t num)
+{
+    uint32_t n = op_n(num);
+    uint32_t val, mod;
+    uint8_t forms, form, ors, ands, ranges, op;
+    int match, group, rel;
+
+    if(p >= end) return LV_I18N_PLURAL_TYPE_OTHER;
+
+    for(forms = *p++; forms > 0; forms--) {
+        if(end - p < 2) return LV_I18N_PLURAL_TYPE_OTHER;
+        form = *p++;
+        match = 0;
+
+        for(ors = *p++; ors > 0; ors--) {
+            if(p >= end) return LV_I18N_PLURAL_TYPE_OTHER;
+            group = 1;
+
+            for(ands = *p++; ands > 0; ands--) {
+                if(end - p < 6) return LV_I18N_PLURAL_TYPE_OTHER;
+                op = p[0];
+                mod = __lv_i18n_rd32(p + 1);
+                ranges = p[5];
+                p += 6;
+
+                // Integers only: n = i = abs(num), other operands are 0
+                val = (op & 0x7F) <= 1 ? n : 0;
+                if(mod != 0) val %= mod;
+
+                if(end - p < (long)ranges * 8) return LV_I18N_PLURAL_TYPE_OTHER;
+                rel = 0;
+                for(; ranges > 0; ranges--, p += 8) {
+                    if(__lv_i18n_rd32(p) <= val && val <= __lv_i18n_rd32(p + 4)) rel = 1;
+                }
+
+                if(op & 0x80) rel = !rel;
+                group = group && rel;
+            }
+
+            match = match || group;
         }
+
+        if(match) return form < _LV_I18N_PLURAL_TYPE_NUM ? form : LV_I18N_PLURAL_TYPE_OTHER;
     }
 
-    return msg_id;
+    return LV_I18N_PLURAL_TYPE_OTHER;
 }
 
-#ifdef LV_I18N_OPTIMIZE
-// Modern compilers calculate phrase IDs at compile time
+#endif
 
-#else
-// Fallback for ancient compilers, search phrase IDs in runtime (slow)
+#ifdef LV_I18N_PLURAL_TABLE
 
-static int __lv_i18n_get_id(const char * phrase, const char * * list, int len)
+static uint8_t __lv_i18n_plural_rule_eval(const lv_i18n_plural_rule_t * rule, int32_t num)
 {
-    uint16_t i;
-    for(i = 0; i < len; i++) {
-        if(strcmp(list[i], phrase) == 0) return i;
+    uint32_t n = op_n(num);
+
+    if(n < rule->forms_size) return rule->forms[n];
+
+    return __lv_i18n_plural_eval(rule->code, rule->code + rule->code_size, num);
+}
+
+#endif
+
+/**
+ * Get plural form of number in locale
+ * @return plural type, or -1 if locale has no plural rules
+ */
+static int __lv_i18n_plural_type(const lv_i18n_lang_t * lang, int32_t num)
+{
+    if(lang->locale_plural_fn != NULL) return lang->locale_plural_fn(num);
+#ifdef LV_I18N_PLURAL_TABLE
+    if(lang->plural_rule != NULL) return __lv_i18n_plural_rule_eval(lang->plural_rule, num);
+#endif
+    return -1;
+}
+
+#ifdef LV_I18N_BINARY
+////////////////////////////////////////////////////////////////////////////////
+// Binary packs, see `lib/binary_pack.js` for format description.
+
+#define LV_I18N_BIN_MAGIC 0x5049564Cu
+#define LV_I18N_BIN_VERSION 2
+#define LV_I18N_BIN_HEADER_SIZE 32
+#define LV_I18N_BIN_LOCALE_SIZE 44
+#define LV_I18N_BIN_BUILTIN_RULES 2
+
+static uint32_t __lv_i18n_rd16(const uint8_t * p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+// Rules without bytecode, must be in sync with `lib/binary_pack.js`
+static uint8_t __lv_i18n_plural_builtin(uint8_t id, int32_t num)
+{
+    switch(id) {
+        case 1:
+            return op_n(num) == 1 ? LV_I18N_PLURAL_TYPE_ONE : LV_I18N_PLURAL_TYPE_OTHER;
+        default:
+            return LV_I18N_PLURAL_TYPE_OTHER;
     }
-    return LV_I18N_ID_NOT_FOUND;
 }
 
-int lv_i18n_get_singular_id(const char * phrase)
+static const uint8_t * __lv_i18n_bin_locale(const uint8_t * bin, uint32_t idx)
 {
-    return __lv_i18n_get_id(phrase, singular_idx, sizeof(singular_idx) / sizeof(singular_idx[0]));
+    return bin + __lv_i18n_rd32(bin + 28) + idx * LV_I18N_BIN_LOCALE_SIZE;
 }
 
-int lv_i18n_get_plural_id(const char * phrase)
+// Pack start, by offset of locale record. Context publishes only locale
+// pointer, so pack and locale always match, even if pack is reloaded
+// while other threads get translations.
+static const uint8_t * __lv_i18n_bin_of(const uint8_t * locale)
 {
-    return __lv_i18n_get_id(phrase, plural_idx, sizeof(plural_idx) / sizeof(plural_idx[0]));
+    return locale - __lv_i18n_rd32(locale + 40);
 }
 
-#endif
+static const char * __lv_i18n_bin_locale_name(const uint8_t * bin, const uint8_t * locale)
+{
+    return (const char *)(bin + __lv_i18n_rd32(locale));
+}
+
+static uint8_t __lv_i18n_bin_plural_type(const uint8_t * bin, const uint8_t * locale, int32_t num)
+{
+    uint32_t rule = __lv_i18n_rd32(locale + 32);
 
+    if(rule == 0) return __lv_i18n_plural_builtin(locale[38], num);
 
-////////////////////////////////////////////////////////////////////////////////
+    return __lv_i18n_plural_eval(bin + rule, bin + rule + __lv_i18n_rd16(locale + 36), num);
+}
+
+// String from table at `field` offset of locale record, or NULL
+static const char * __lv_i18n_bin_str(const uint8_t * bin, const uint8_t * locale, uint32_t field, int msg_index)
+{
+    uint32_t table = __lv_i18n_rd32(locale + field);
+    uint32_t str;
+
+    if(table == 0) return NULL;
 
+    str = __lv_i18n_rd32(bin + table + (uint32_t)msg_index * 4);
+    return str != 0 ? (const char *)(bin + str) : NULL;
+}
+
+static const char * __lv_i18n_bin_get_singular(const uint8_t * bin, const uint8_t * locale,
+                                               const char * msg_id, int msg_index, __lv_i18n_found_t * found)
+{
+    const uint8_t * base = __lv_i18n_bin_locale(bin, 0);
+    const char * txt = __lv_i18n_bin_str(bin, locale, 4, msg_index);
+
+    if(txt != NULL) {
+        LV_I18N_FOUND_KIND(found, LV_I18N_STATS_HIT);
+        return txt;
+    }
+
+    if(locale != base) txt = __lv_i18n_bin_str(bin, base, 4, msg_index);
+
+    LV_I18N_FOUND_KIND(found, txt != NULL ? LV_I18N_STATS_FALLBACK : LV_I18N_STATS_MISS);
+    return txt != NULL ? txt : msg_id;
+}
 
+static const char * __lv_i18n_bin_get_plural(const uint8_t * bin, const uint8_t * locale,
+                                             const char * msg_id, int msg_index, int32_t num,
+                                             __lv_i18n_found_t * found)
+{
+    const uint8_t * base = __lv_i18n_bin_locale(bin, 0);
+    const char * txt = __lv_i18n_bin_str(bin, locale, 8 + 4u * __lv_i18n_bin_plural_type(bin, locale, num), msg_index);
+
+    if(txt != NULL) {
+        LV_I18N_FOUND_KIND(found, LV_I18N_STATS_HIT);
+        return txt;
+    }
+
+    if(locale != base) {
+        txt = __lv_i18n_bin_str(bin, base, 8 + 4u * __lv_i18n_bin_plural_type(bin, base, num), msg_index);
+    }
+
+    LV_I18N_FOUND_KIND(found, txt != NULL ? LV_I18N_STATS_FALLBACK : LV_I18N_STATS_MISS);
+    return txt != NULL ? txt : msg_id;
+}
 
 /**
- * Reset internal state. For testing.
+ * Load binary translations pack into context and switch to its first locale
+ * @param ctx context
+ * @param data pointer to pack, used in place (must stay valid while used)
+ * @param size size of available data
+ * @return 0 on success, -1 if pack is damaged or does not match phrase IDs
  */
-void __lv_i18n_reset(void)
+int lv_i18n_ctx_load_pack_from_memory(lv_i18n_ctx_t * ctx, const void * data, size_t size)
 {
-    current_lang_pack = NULL;
-    current_lang = NULL;
+    const uint8_t * bin = (const uint8_t *)data;
+    const uint8_t * locale;
+    const char * old_locale;
+    uint32_t pack_size, locales, count, keys, table, rule, i, j, k;
+    uint32_t h = 0x811c9dc5u;
+
+    if(bin == NULL || size < LV_I18N_BIN_HEADER_SIZE) return -1;
+
+    pack_size = __lv_i18n_rd32(bin + 8);
+
+    if(__lv_i18n_rd32(bin) != LV_I18N_BIN_MAGIC ||
+       __lv_i18n_rd16(bin + 4) != LV_I18N_BIN_VERSION ||
+       pack_size <= LV_I18N_BIN_HEADER_SIZE || pack_size > size) return -1;
+
+    // Pack is for another set of phrases, IDs do not match
+    if(__lv_i18n_rd32(bin + 16) != LV_I18N_KEYS_HASH) return -1;
+
+    // Tables are indexed by phrase IDs without checks, need entry for each
+    if(__lv_i18n_rd16(bin + 20) != LV_I18N_SINGULAR_COUNT ||
+       __lv_i18n_rd16(bin + 22) != LV_I18N_PLURAL_COUNT) return -1;
+
+    // FNV-1a checksum
+    for(i = 16; i < pack_size; i++) {
+        h ^= bin[i];
+        h *= 0x01000193u;
+    }
+    if(h != __lv_i18n_rd32(bin + 12)) return -1;
+
+    // Validate offsets, to make sure lookups never read outside of pack.
+    // Last byte is zero, so any string offset inside is terminated.
+    if(bin[pack_size - 1] != 0) return -1;
+
+    count = __lv_i18n_rd16(bin + 24);
+    locales = __lv_i18n_rd32(bin + 28);
+
+    if(count == 0 || locales > pack_size || (pack_size - locales) / LV_I18N_BIN_LOCALE_SIZE < count) return -1;
+
+    for(i = 0; i < count; i++) {
+        locale = bin + locales + i * LV_I18N_BIN_LOCALE_SIZE;
+
+        if(__lv_i18n_rd32(locale) == 0 || __lv_i18n_rd32(locale) >= pack_size) return -1;
+
+        // Singulars + plural forms tables
+        for(j = 0; j < 1 + _LV_I18N_PLURAL_TYPE_NUM; j++) {
+            table = __lv_i18n_rd32(locale + 4 + j * 4);
+            keys = __lv_i18n_rd16(bin + (j == 0 ? 20 : 22));
+
+            if(table == 0) continue;
+            if(table > pack_size || (pack_size - table) / 4 < keys) return -1;
+
+            for(k = 0; k < keys; k++) {
+                if(__lv_i18n_rd32(bin + table + k * 4) >= pack_size) return -1;
+            }
+        }
+
+        if(__lv_i18n_rd32(locale + 40) != locales + i * LV_I18N_BIN_LOCALE_SIZE) return -1;
+
+        rule = __lv_i18n_rd32(locale + 32);
+
+        if(rule > pack_size || pack_size - rule < __lv_i18n_rd16(locale + 36)) return -1;
+        if(rule == 0 && locale[38] >= LV_I18N_BIN_BUILTIN_RULES) return -1;
+    }
+
+    old_locale = lv_i18n_ctx_get_current_locale(ctx);
+    LV_I18N_ATOMIC_STORE(&ctx->bin_locale, bin + locales);
+    __lv_i18n_ctx_notify(ctx, old_locale, NULL);
+    return 0;
 }
 
 /**
- * Set the languages for internationalization
- * @param langs pointer to the array of languages. (Last element has to be `NULL`)
+ * Load binary translations pack into default context
  */
-int lv_i18n_init(const lv_i18n_language_pack_t * langs)
+int lv_i18n_load_pack_from_memory(const void * data, size_t size)
 {
-    if(langs == NULL) return -1;
-    if(langs[0] == NULL) return -1;
+    return lv_i18n_ctx_load_pack_from_memory(&default_ctx, data, size);
+}
 
-    current_lang_pack = langs;
-    current_lang = langs[0];     /*Automatically select the first language*/
-    return 0;
+#endif
+
+// Base locale to search after `lang`, NULL if no fallback
+static const lv_i18n_lang_t * __lv_i18n_ctx_base(const lv_i18n_ctx_t * ctx, const lv_i18n_lang_t * lang)
+{
+    return lang == ctx->lang_pack[0] ? NULL : ctx->lang_pack[0];
 }
 
 /**
- * Sugar for simplified `lv_i18n_init` call
+ * Search singular translation in `lang`, then in `base` locale
+ * @param base locale to fallback, NULL if none
+ * @param found if not NULL, filled with details of result
+ * @return translation, NULL if not found
  */
-int lv_i18n_init_default(void)
+static const char * __lv_i18n_lang_find_singular(const lv_i18n_lang_t * lang, const lv_i18n_lang_t * base,
+                                                 int msg_index, __lv_i18n_found_t * found)
 {
-    return lv_i18n_init(lv_i18n_language_pack);
+    const char * txt;
+
+    // Search in current locale
+    if(lang->singulars != NULL) {
+        txt = LV_I18N_STR(lang, singulars[msg_index]);
+        if (txt != NULL) {
+            LV_I18N_FOUND(found, LV_I18N_STATS_HIT, lang->singular_fmts, lang->singular_info, msg_index);
+            return txt;
+        }
+    }
+
+    if(base == NULL) return NULL;
+#ifdef LV_I18N_RESOLVED_FALLBACK
+    // Fallbacks to base locale are already baked into tables by compiler.
+    // Packs made by hand still need runtime search.
+    if(lang->resolved) return NULL;
+#endif
+    lang = base;
+
+    // Repeat search for default locale
+    if(lang->singulars != NULL) {
+        txt = LV_I18N_STR(lang, singulars[msg_index]);
+        if (txt != NULL) {
+            LV_I18N_FOUND(found, LV_I18N_STATS_FALLBACK, lang->singular_fmts, lang->singular_info, msg_index);
+            return txt;
+        }
+    }
+
+    return NULL;
 }
 
 /**
- * Change the localization (language)
- * @param l_name name of the translation locale to use. E.g. "en-GB"
+ * Search plural translation in `lang`, then in `base` locale
+ * @param base locale to fallback, NULL if none
+ * @param found if not NULL, filled with details of result
+ * @return translation, NULL if not found
  */
-int lv_i18n_set_locale(const char * l_name)
+static const char * __lv_i18n_lang_find_plural(const lv_i18n_lang_t * lang, const lv_i18n_lang_t * base,
+                                               int msg_index, int32_t num, __lv_i18n_found_t * found)
 {
-    if(current_lang_pack == NULL) return -1;
+    const char * txt;
+    int ptype;
+    uint8_t kind = LV_I18N_STATS_HIT;
+
+    // Phrase not translated at all - go to base locale at once
+    if(base != NULL && lang->plural_fallback != NULL &&
+       (lang->plural_fallback[msg_index >> 3] & (1 << (msg_index & 7)))) {
+        lang = base;
+        base = NULL;
+        kind = LV_I18N_STATS_FALLBACK;
+    }
 
-    uint16_t i;
+    // Search in current locale
+    ptype = __lv_i18n_plural_type(lang, num);
 
-    for(i = 0; current_lang_pack[i] != NULL; i++) {
-        // Found -> finish
-        if(strcmp(current_lang_pack[i]->locale_name, l_name) == 0) {
-            current_lang = current_lang_pack[i];
-            return 0;
+    if(ptype >= 0 && lang->plurals[ptype] != NULL) {
+        txt = LV_I18N_STR(lang, plurals[ptype][msg_index]);
+        if (txt != NULL) {
+            LV_I18N_FOUND(found, kind, lang->plural_fmts[ptype], lang->plural_info[ptype], msg_index);
+            return txt;
         }
     }
 
-    return -1;
+    // Try to fallback
+    if(base == NULL) return NULL;
+    lang = base;
+
+    // Repeat search for default locale
+    ptype = __lv_i18n_plural_type(lang, num);
+
+    if(ptype >= 0 && lang->plurals[ptype] != NULL) {
+        txt = LV_I18N_STR(lang, plurals[ptype][msg_index]);
+        if (txt != NULL) {
+            LV_I18N_FOUND(found, LV_I18N_STATS_FALLBACK, lang->plural_fmts[ptype], lang->plural_info[ptype],
+                          msg_index);
+            return txt;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Search singular translation
+ * @param found if not NULL, filled with details of result
+ */
+static const char * __lv_i18n_ctx_find_singular(const lv_i18n_ctx_t * ctx, const char * msg_id, int msg_index,
+                                                __lv_i18n_found_t * found)
+{
+    const lv_i18n_lang_t * lang;
+    const char * txt;
+#ifdef LV_I18N_BINARY
+    const uint8_t * bin_locale = LV_I18N_ATOMIC_LOAD(&ctx->bin_locale);
+
+    if(bin_locale != NULL && msg_index != LV_I18N_ID_NOT_FOUND) {
+        return __lv_i18n_bin_get_singular(__lv_i18n_bin_of(bin_locale), bin_locale, msg_id, msg_index, found);
+    }
+#endif
+
+    // Locale is read once, switch from another thread can not break lookup
+    lang = LV_I18N_ATOMIC_LOAD(&ctx->lang);
+
+    LV_I18N_FOUND_KIND(found, LV_I18N_STATS_MISS);
+
+    if(lang == NULL || msg_index == LV_I18N_ID_NOT_FOUND) return msg_id;
+
+    txt = __lv_i18n_lang_find_singular(lang, __lv_i18n_ctx_base(ctx, lang), msg_index, found);
+    return txt != NULL ? txt : msg_id;
+}
+
+/**
+ * Search plural translation
+ * @param found if not NULL, filled with details of result
+ */
+static const char * __lv_i18n_ctx_find_plural(const lv_i18n_ctx_t * ctx, const char * msg_id, int msg_index,
+                                              int32_t num, __lv_i18n_found_t * found)
+{
+    const lv_i18n_lang_t * lang;
+    const char * txt;
+#ifdef LV_I18N_BINARY
+    const uint8_t * bin_locale = LV_I18N_ATOMIC_LOAD(&ctx->bin_locale);
+
+    if(bin_locale != NULL && msg_index != LV_I18N_ID_NOT_FOUND) {
+        return __lv_i18n_bin_get_plural(__lv_i18n_bin_of(bin_locale), bin_locale, msg_id, msg_index, num, found);
+    }
+#endif
+
+    lang = LV_I18N_ATOMIC_LOAD(&ctx->lang);
+
+    LV_I18N_FOUND_KIND(found, LV_I18N_STATS_MISS);
+
+    if(lang == NULL || msg_index == LV_I18N_ID_NOT_FOUND) return msg_id;
+
+    txt = __lv_i18n_lang_find_plural(lang, __lv_i18n_ctx_base(ctx, lang), msg_index, num, found);
+    return txt != NULL ? txt : msg_id;
+}
+
+#if defined(LV_I18N_STATS) || defined(LV_I18N_LOCALE_DIFF)
+// ID of compiled locale, LV_I18N_LOCALE_COUNT for custom packs
+static uint32_t __lv_i18n_compiled_id(const lv_i18n_lang_t * lang)
+{
+    uint32_t i;
+
+    for(i = 0; i < LV_I18N_LOCALE_COUNT; i++) {
+        if(LV_I18N_COMPILED_LANG(i) == lang) return i;
+    }
+
+    return LV_I18N_LOCALE_COUNT;
+}
+#endif
+
+#ifdef LV_I18N_STATS
+////////////////////////////////////////////////////////////////////////////////
+// Lookup statistics (`LV_I18N_STATS` build mode)
+
+// Timestamp for lookup time, define with cycle counter for precise numbers
+#ifndef LV_I18N_STATS_TIME
+#include <time.h>
+#define LV_I18N_STATS_TIME() ((uint32_t)clock())
+#endif
+
+static lv_i18n_stats_t stats;
+static lv_i18n_miss_cb_t miss_cb;
+
+// Index of current locale in `stats.locales`, the last one for
+// custom & binary packs
+static uint32_t __lv_i18n_stats_locale(const lv_i18n_ctx_t * ctx)
+{
+#ifdef LV_I18N_BINARY
+    if(LV_I18N_ATOMIC_LOAD(&ctx->bin_locale) != NULL) return LV_I18N_LOCALE_COUNT;
+#endif
+
+    return __lv_i18n_compiled_id(LV_I18N_ATOMIC_LOAD(&ctx->lang));
+}
+
+static void __lv_i18n_stats_count(lv_i18n_stats_counter_t * c, uint8_t kind, uint32_t time)
+{
+    if(kind == LV_I18N_STATS_HIT) c->hits++;
+    else if(kind == LV_I18N_STATS_FALLBACK) c->fallbacks++;
+    else c->misses++;
+
+    c->time += time;
+}
+
+static void __lv_i18n_stats_add(const lv_i18n_ctx_t * ctx, const char * msg_id, int msg_index, int plural,
+                                uint8_t kind, uint32_t start)
+{
+    uint32_t time = LV_I18N_STATS_TIME() - start;
+    lv_i18n_miss_t reason;
+
+    __lv_i18n_stats_count(&stats.locales[__lv_i18n_stats_locale(ctx)], kind, time);
+
+    if(msg_index == LV_I18N_ID_NOT_FOUND) {
+        stats.not_found++;
+        reason = LV_I18N_MISS_UNKNOWN;
+    }
+    else {
+        __lv_i18n_stats_count(plural ? &stats.plurals[msg_index] : &stats.singulars[msg_index], kind, time);
+        reason = kind == LV_I18N_STATS_FALLBACK ? LV_I18N_MISS_FALLBACK : LV_I18N_MISS_UNTRANSLATED;
+    }
+
+    if(miss_cb != NULL && kind != LV_I18N_STATS_HIT) {
+        miss_cb(lv_i18n_ctx_get_current_locale(ctx), msg_id, plural, reason);
+    }
+}
+
+/**
+ * Get lookup statistics, collected since start or last reset
+ */
+const lv_i18n_stats_t * lv_i18n_stats_get(void)
+{
+    return &stats;
+}
+
+/**
+ * Reset lookup statistics
+ */
+void lv_i18n_stats_reset(void)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+/**
+ * Set function, called for each lookup without translation in current locale
+ */
+void lv_i18n_set_miss_callback(lv_i18n_miss_cb_t cb)
+{
+    miss_cb = cb;
+}
+
+static void __lv_i18n_stats_print(void (*print)(const char * line), const char * kind, const char * name,
+                                  const lv_i18n_stats_counter_t * c)
+{
+    char line[128];
+
+    if(c->hits == 0 && c->fallbacks == 0 && c->misses == 0) return;
+
+    LV_I18N_SNPRINTF(line, sizeof(line), "%s \"%s\": hits %lu, fallbacks %lu, misses %lu, time %lu", kind, name,
+                     (unsigned long)c->hits, (unsigned long)c->fallbacks, (unsigned long)c->misses,
+                     (unsigned long)c->time);
+    print(line);
+}
+
+/**
+ * Print statistics line by line: locales, then phrases with non-zero counters
+ * @param print function to output line (without "\n")
+ */
+void lv_i18n_stats_dump(void (*print)(const char * line))
+{
+    char line[64];
+    uint32_t i;
+
+    for(i = 0; i < LV_I18N_LOCALE_COUNT; i++) {
+        __lv_i18n_stats_print(print, "locale", LV_I18N_COMPILED_NAME(i), &stats.locales[i]);
+    }
+    __lv_i18n_stats_print(print, "locale", "(other)", &stats.locales[LV_I18N_LOCALE_COUNT]);
+
+    for(i = 0; i < LV_I18N_SINGULAR_COUNT; i++) {
+        __lv_i18n_stats_print(print, "singular", singular_idx[i], &stats.singulars[i]);
+    }
+    for(i = 0; i < LV_I18N_PLURAL_COUNT; i++) {
+        __lv_i18n_stats_print(print, "plural", plural_idx[i], &stats.plurals[i]);
+    }
+
+    LV_I18N_SNPRINTF(line, sizeof(line), "unknown phrases: %lu", (unsigned long)stats.not_found);
+    print(line);
+}
+
+#endif
+
+// Search translation, with statistics (if enabled)
+static const char * __lv_i18n_ctx_singular(const lv_i18n_ctx_t * ctx, const char * msg_id, int msg_index,
+                                           __lv_i18n_found_t * found)
+{
+#ifdef LV_I18N_STATS
+    __lv_i18n_found_t tmp;
+    uint32_t start = LV_I18N_STATS_TIME();
+    const char * txt;
+
+    if(found == NULL) found = &tmp;
+    txt = __lv_i18n_ctx_find_singular(ctx, msg_id, msg_index, found);
+    __lv_i18n_stats_add(ctx, msg_id, msg_index, 0, found->kind, start);
+    return txt;
+#else
+    return __lv_i18n_ctx_find_singular(ctx, msg_id, msg_index, found);
+#endif
+}
+
+static const char * __lv_i18n_ctx_plural(const lv_i18n_ctx_t * ctx, const char * msg_id, int msg_index, int32_t num,
+                                         __lv_i18n_found_t * found)
+{
+#ifdef LV_I18N_STATS
+    __lv_i18n_found_t tmp;
+    uint32_t start = LV_I18N_STATS_TIME();
+    const char * txt;
+
+    if(found == NULL) found = &tmp;
+    txt = __lv_i18n_ctx_find_plural(ctx, msg_id, msg_index, num, found);
+    __lv_i18n_stats_add(ctx, msg_id, msg_index, 1, found->kind, start);
+    return txt;
+#else
+    return __lv_i18n_ctx_find_plural(ctx, msg_id, msg_index, num, found);
+#endif
+}
+
+/**
+ * Get the translation from a message ID
+ * @param ctx context
+ * @param msg_id message ID
+ * @param msg_index the index of the msg_id
+ * @return the translation of `msg_id` on the set local
+ */
+const char * lv_i18n_ctx_get_singular_by_idx(const lv_i18n_ctx_t * ctx, const char * msg_id, int msg_index)
+{
+    return __lv_i18n_ctx_singular(ctx, msg_id, msg_index, NULL);
+}
+
+/**
+ * Get the translation from a message ID and apply the language's plural rule to get correct form
+ * @param ctx context
+ * @param msg_id message ID
+ * @param msg_index the index of the msg_id
+ * @param num an integer to select the correct plural form
+ * @return the translation of `msg_id` on the set local
+ */
+const char * lv_i18n_ctx_get_plural_by_idx(const lv_i18n_ctx_t * ctx, const char * msg_id, int msg_index, int32_t num)
+{
+    return __lv_i18n_ctx_plural(ctx, msg_id, msg_index, num, NULL);
+}
+
+/**
+ * Get the translation from a message ID, in default context
+ * @param msg_id message ID
+ * @param msg_index the index of the msg_id
+ * @return the translation of `msg_id` on the set local
+ */
+const char * lv_i18n_get_singular_by_idx(const char * msg_id, int msg_index)
+{
+    return lv_i18n_ctx_get_singular_by_idx(&default_ctx, msg_id, msg_index);
+}
+
+/**
+ * Get the translation from a message ID and apply the language's plural rule, in default context
+ * @param msg_id message ID
+ * @param msg_index the index of the msg_id
+ * @param num an integer to select the correct plural form
+ * @return the translation of `msg_id` on the set local
+ */
+const char * lv_i18n_get_plural_by_idx(const char * msg_id, int msg_index, int32_t num)
+{
+    return lv_i18n_ctx_get_plural_by_idx(&default_ctx, msg_id, msg_index, num);
+}
+
+#if defined(__GNUC__) && !defined(LV_I18N_COMPRESS)
+/**
+ * Get translation in default context and store it in call site cache
+ * @param cache cache of `_i()` call site
+ * @param msg_id message ID
+ * @param msg_index the index of the msg_id
+ * @return the translation of `msg_id` on the set local
+ */
+const char * lv_i18n_cache_fill(lv_i18n_cache_t * cache, const char * msg_id, int msg_index)
+{
+    // Generation is taken before lookup, so if locale is switched meanwhile,
+    // entry is stale at once
+    uintptr_t gen = LV_I18N_ATOMIC_LOAD(&lv_i18n_generation);
+    const char * str = lv_i18n_get_singular_by_idx(msg_id, msg_index);
+    uint32_t seq = __atomic_load_n(&cache->seq, __ATOMIC_RELAXED);
+
+    // Entry is written by another thread, leave it
+    if((seq & 1) != 0 ||
+       !__atomic_compare_exchange_n(&cache->seq, &seq, seq + 1, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        return str;
+    }
+
+    // Odd counter is visible before data
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&cache->str, str, __ATOMIC_RELAXED);
+    __atomic_store_n(&cache->gen, gen, __ATOMIC_RELAXED);
+    __atomic_store_n(&cache->seq, seq + 2, __ATOMIC_RELEASE);
+    return str;
+}
+#endif
+
+#ifndef LV_I18N_COMPRESS
+/**
+ * Get translations of many singular phrases in one pass (labels of a screen,
+ * for example). Locale & fallback are chosen once, so all results are of
+ * the same locale, even if it is switched by another thread meanwhile.
+ * @param ctx context
+ * @param idx indexes of phrases (see `lv_i18n_get_singular_id()`)
+ * @param n number of phrases
+ * @param out filled with `n` translations, NULL if phrase is not translated
+ * @return number of not translated phrases
+ */
+size_t lv_i18n_ctx_get_singular_batch(const lv_i18n_ctx_t * ctx, const uint16_t * idx, size_t n, const char ** out)
+{
+    size_t i;
+    size_t missed = 0;
+#ifdef LV_I18N_STATS
+    __lv_i18n_found_t found;
+
+    // Every phrase is accounted as separate lookup
+    for(i = 0; i < n; i++) {
+        const char * msg_id = idx[i] != LV_I18N_ID_NOT_FOUND ? singular_idx[idx[i]] : NULL;
+
+        out[i] = __lv_i18n_ctx_singular(ctx, msg_id, idx[i], &found);
+        if(found.kind == LV_I18N_STATS_MISS) {
+            out[i] = NULL;
+            missed++;
+        }
+    }
+    return missed;
+#else
+    const lv_i18n_lang_t * lang;
+    const lv_i18n_lang_t * base;
+#ifdef LV_I18N_BINARY
+    const uint8_t * bin_locale = LV_I18N_ATOMIC_LOAD(&ctx->bin_locale);
+
+    if(bin_locale != NULL) {
+        const uint8_t * bin = __lv_i18n_bin_of(bin_locale);
+
+        for(i = 0; i < n; i++) {
+            out[i] = idx[i] != LV_I18N_ID_NOT_FOUND ?
+                     __lv_i18n_bin_get_singular(bin, bin_locale, NULL, idx[i], NULL) : NULL;
+            if(out[i] == NULL) missed++;
+        }
+        return missed;
+    }
+#endif
+
+    lang = LV_I18N_ATOMIC_LOAD(&ctx->lang);
+
+    if(lang == NULL) {
+        for(i = 0; i < n; i++) out[i] = NULL;
+        return n;
+    }
+
+    base = __lv_i18n_ctx_base(ctx, lang);
+
+    for(i = 0; i < n; i++) {
+        out[i] = idx[i] != LV_I18N_ID_NOT_FOUND ? __lv_i18n_lang_find_singular(lang, base, idx[i], NULL) : NULL;
+        if(out[i] == NULL) missed++;
+    }
+    return missed;
+#endif
+}
+
+/**
+ * Same as `lv_i18n_ctx_get_singular_batch()`, for plurals
+ * @param ctx context
+ * @param idx indexes of phrases (see `lv_i18n_get_plural_id()`)
+ * @param num numbers to select plural forms, one per phrase
+ * @param n number of phrases
+ * @param out filled with `n` translations, NULL if phrase is not translated
+ * @return number of not translated phrases
+ */
+size_t lv_i18n_ctx_get_plural_batch(const lv_i18n_ctx_t * ctx, const uint16_t * idx, const int32_t * num, size_t n,
+                                    const char ** out)
+{
+    size_t i;
+    size_t missed = 0;
+#ifdef LV_I18N_STATS
+    __lv_i18n_found_t found;
+
+    for(i = 0; i < n; i++) {
+        const char * msg_id = idx[i] != LV_I18N_ID_NOT_FOUND ? plural_idx[idx[i]] : NULL;
+
+        out[i] = __lv_i18n_ctx_plural(ctx, msg_id, idx[i], num[i], &found);
+        if(found.kind == LV_I18N_STATS_MISS) {
+            out[i] = NULL;
+            missed++;
+        }
+    }
+    return missed;
+#else
+    const lv_i18n_lang_t * lang;
+    const lv_i18n_lang_t * base;
+#ifdef LV_I18N_BINARY
+    const uint8_t * bin_locale = LV_I18N_ATOMIC_LOAD(&ctx->bin_locale);
+
+    if(bin_locale != NULL) {
+        const uint8_t * bin = __lv_i18n_bin_of(bin_locale);
+
+        for(i = 0; i < n; i++) {
+            out[i] = idx[i] != LV_I18N_ID_NOT_FOUND ?
+                     __lv_i18n_bin_get_plural(bin, bin_locale, NULL, idx[i], num[i], NULL) : NULL;
+            if(out[i] == NULL) missed++;
+        }
+        return missed;
+    }
+#endif
+
+    lang = LV_I18N_ATOMIC_LOAD(&ctx->lang);
+
+    if(lang == NULL) {
+        for(i = 0; i < n; i++) out[i] = NULL;
+        return n;
+    }
+
+    base = __lv_i18n_ctx_base(ctx, lang);
+
+    for(i = 0; i < n; i++) {
+        out[i] = idx[i] != LV_I18N_ID_NOT_FOUND ? __lv_i18n_lang_find_plural(lang, base, idx[i], num[i], NULL) : NULL;
+        if(out[i] == NULL) missed++;
+    }
+    return missed;
+#endif
+}
+
+/**
+ * Same as `lv_i18n_ctx_get_singular_batch()`, in default context
+ */
+size_t lv_i18n_get_singular_batch(const uint16_t * idx, size_t n, const char ** out)
+{
+    return lv_i18n_ctx_get_singular_batch(&default_ctx, idx, n, out);
+}
+
+/**
+ * Same as `lv_i18n_ctx_get_plural_batch()`, in default context
+ */
+size_t lv_i18n_get_plural_batch(const uint16_t * idx, const int32_t * num, size_t n, const char ** out)
+{
+    return lv_i18n_ctx_get_plural_batch(&default_ctx, idx, num, n, out);
+}
+#endif
+
+#ifdef LV_I18N_STRING_INFO
+////////////////////////////////////////////////////////////////////////////////
+// Translations with metadata (`--string-info` option)
+
+// Calculate metadata, when it's not precomputed. Must be in sync with
+// `str_info()` in `lib/compiler_template.js`
+static void __lv_i18n_str_info(const char * str, lv_i18n_str_info_t * info)
+{
+    uint32_t hash = 0x811c9dc5u;
+    uint32_t len = 0;
+    uint32_t chars = 0;
+
+    for(; str[len] != '\0'; len++) {
+        uint8_t c = (uint8_t)str[len];
+
+        hash = (hash ^ c) * 0x01000193u;
+        if((c & 0xC0) != 0x80) chars++; // not UTF-8 continuation byte
+    }
+
+    info->len = (uint16_t)(len < 0xFFFF ? len : 0xFFFF);
+    info->chars = (uint16_t)(chars < 0xFFFF ? chars : 0xFFFF);
+    info->hash = hash;
+}
+
+static const char * __lv_i18n_with_info(const char * str, const __lv_i18n_found_t * found,
+                                        lv_i18n_str_info_t * info)
+{
+    if(info == NULL) return str;
+
+    if(found->info != NULL) *info = *found->info;
+    else __lv_i18n_str_info(str, info);
+
+    return str;
+}
+
+/**
+ * Get singular translation and its metadata
+ * @param ctx context
+ * @param msg_id message ID
+ * @param msg_index the index of the msg_id
+ * @param info filled with metadata of returned string
+ * @return the translation of `msg_id` on the set local
+ */
+const char * lv_i18n_ctx_get_singular_info_by_idx(const lv_i18n_ctx_t * ctx, const char * msg_id, int msg_index,
+                                                  lv_i18n_str_info_t * info)
+{
+    __lv_i18n_found_t found = { NULL, LV_I18N_STATS_MISS, NULL };
+    const char * str = __lv_i18n_ctx_singular(ctx, msg_id, msg_index, &found);
+
+    return __lv_i18n_with_info(str, &found, info);
+}
+
+/**
+ * Get plural translation and its metadata
+ * @param ctx context
+ * @param msg_id message ID
+ * @param msg_index the index of the msg_id
+ * @param num an integer to select the correct plural form
+ * @param info filled with metadata of returned string
+ * @return the translation of `msg_id` on the set local
+ */
+const char * lv_i18n_ctx_get_plural_info_by_idx(const lv_i18n_ctx_t * ctx, const char * msg_id, int msg_index,
+                                                int32_t num, lv_i18n_str_info_t * info)
+{
+    __lv_i18n_found_t found = { NULL, LV_I18N_STATS_MISS, NULL };
+    const char * str = __lv_i18n_ctx_plural(ctx, msg_id, msg_index, num, &found);
+
+    return __lv_i18n_with_info(str, &found, info);
+}
+
+/**
+ * Get singular translation and its metadata, in default context
+ */
+const char * lv_i18n_get_singular_info_by_idx(const char * msg_id, int msg_index, lv_i18n_str_info_t * info)
+{
+    return lv_i18n_ctx_get_singular_info_by_idx(&default_ctx, msg_id, msg_index, info);
+}
+
+/**
+ * Get plural translation and its metadata, in default context
+ */
+const char * lv_i18n_get_plural_info_by_idx(const char * msg_id, int msg_index, int32_t num,
+                                            lv_i18n_str_info_t * info)
+{
+    return lv_i18n_ctx_get_plural_info_by_idx(&default_ctx, msg_id, msg_index, num, info);
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Formatting, `lv_i18n_format()`
+
+// Must be in sync with `arg_types` in `lib/format.js`
+#define LV_I18N_ARG_INT 1
+#define LV_I18N_ARG_UINT 2
+#define LV_I18N_ARG_LONG 3
+#define LV_I18N_ARG_ULONG 4
+#define LV_I18N_ARG_LLONG 5
+#define LV_I18N_ARG_ULLONG 6
+#define LV_I18N_ARG_SIZE 7
+#define LV_I18N_ARG_DOUBLE 8
+#define LV_I18N_ARG_STR 9
+#define LV_I18N_ARG_PTR 10
+
+#define LV_I18N_FORMAT_MAX_ARGS 9
+#define LV_I18N_FORMAT_MAX_SPEC 15
+
+typedef union {
+    int i;
+    unsigned u;
+    long l;
+    unsigned long ul;
+    long long ll;
+    unsigned long long ull;
+    size_t z;
+    double d;
+    const char * s;
+    const void * p;
+} __lv_i18n_fmt_arg_t;
+
+// Token with full size offsets, for strings parsed in runtime
+typedef struct {
+    size_t start;
+    size_t len;
+    uint8_t arg;
+    uint8_t type;
+} __lv_i18n_fmt_tok_t;
+
+// Iterates pre-parsed tokens, or parses string if those not exist
+typedef struct {
+    const char * str;
+    const lv_i18n_fmt_token_t * tokens;
+    size_t pos;     // token index or current offset in string
+    size_t lit;     // start of pending literal text
+    unsigned seq;   // sequential arguments counter
+    int has_spec;   // spec, found after literal, is returned by next call
+    __lv_i18n_fmt_tok_t spec;
+} __lv_i18n_fmt_iter_t;
+
+// Phrase being formatted, to find its translation in base locale
+typedef struct {
+    const lv_i18n_ctx_t * ctx;
+    int msg_index;
+    int plural;
+    int32_t num;
+} __lv_i18n_fmt_src_t;
+
+static int __lv_i18n_is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static uint8_t __lv_i18n_fmt_type(char length, int twice, char conv)
+{
+    int is_signed = conv == 'd' || conv == 'i';
+
+    if(conv == 'c') return LV_I18N_ARG_INT;
+    if(conv == 's') return LV_I18N_ARG_STR;
+    if(conv == 'p') return LV_I18N_ARG_PTR;
+    if(strchr("fFeEgGaA", conv) != NULL) return LV_I18N_ARG_DOUBLE;
+    if(length == 'z') return LV_I18N_ARG_SIZE;
+    if(length == 'l' && twice) return is_signed ? LV_I18N_ARG_LLONG : LV_I18N_ARG_ULLONG;
+    if(length == 'l') return is_signed ? LV_I18N_ARG_LONG : LV_I18N_ARG_ULONG;
+    return is_signed ? LV_I18N_ARG_INT : LV_I18N_ARG_UINT;
+}
+
+/**
+ * Parse spec after `%` at offset `p`, same as `parse_spec()` in `lib/format.js`
+ * @return offset after spec, or 0 if spec is invalid
+ */
+static size_t __lv_i18n_fmt_parse_spec(const char * str, size_t p, unsigned * seq, __lv_i18n_fmt_tok_t * tok)
+{
+    size_t j = p;
+    size_t start;
+    unsigned arg = 0;
+    char length = '\0';
+    int twice = 0;
+    char conv;
+
+    for(; __lv_i18n_is_digit(str[j]); j++) {
+        if(arg <= LV_I18N_FORMAT_MAX_ARGS) arg = arg * 10 + (unsigned)(str[j] - '0');
+    }
+
+    if(j > p && str[j] == '$') {
+        if(arg < 1 || arg > LV_I18N_FORMAT_MAX_ARGS) return 0;
+        p = j + 1;
+    }
+    else {
+        arg = 0;
+    }
+
+    start = p;
+
+    while(str[p] != '\0' && strchr("-+ #0", str[p]) != NULL) p++;
+    while(__lv_i18n_is_digit(str[p])) p++;
+    if(str[p] == '.') {
+        p++;
+        while(__lv_i18n_is_digit(str[p])) p++;
+    }
+
+    if(str[p] == 'h' || str[p] == 'l') {
+        length = str[p++];
+        if(str[p] == length) {
+            twice = 1;
+            p++;
+        }
+    }
+    else if(str[p] == 'z') {
+        length = str[p++];
+    }
+
+    conv = str[p];
+
+    if(conv == '\0' || strchr("diuxXocspfFeEgGaA", conv) == NULL || p + 1 - start > LV_I18N_FORMAT_MAX_SPEC) return 0;
+
+    // Out of range sequential argument is printed as is, like invalid spec
+    if(arg == 0) arg = ++(*seq);
+    if(arg > LV_I18N_FORMAT_MAX_ARGS) return 0;
+
+    tok->start = start;
+    tok->len = p + 1 - start;
+    tok->arg = (uint8_t)arg;
+    tok->type = __lv_i18n_fmt_type(length, twice, conv);
+
+    return p + 1;
+}
+
+static void __lv_i18n_fmt_iter_init(__lv_i18n_fmt_iter_t * it, const char * str, const lv_i18n_fmt_token_t * tokens)
+{
+    memset(it, 0, sizeof(*it));
+    it->str = str;
+    it->tokens = tokens;
+}
+
+/**
+ * Get next token of format string
+ * @return 0 at the end
+ */
+static int __lv_i18n_fmt_next(__lv_i18n_fmt_iter_t * it, __lv_i18n_fmt_tok_t * tok)
+{
+    const char * str = it->str;
+    size_t p, end;
+
+    if(it->tokens != NULL) {
+        const lv_i18n_fmt_token_t * t = &it->tokens[it->pos];
+
+        if(t->len == 0 && t->arg == 0) return 0;
+
+        it->pos++;
+        tok->start = t->start;
+        tok->len = t->len;
+        tok->arg = t->arg;
+        tok->type = t->type;
+        return 1;
+    }
+
+    if(it->has_spec) {
+        it->has_spec = 0;
+        *tok = it->spec;
+        return 1;
+    }
+
+    while(str[it->pos] != '\0') {
+        p = it->pos;
+
+        if(str[p] != '%') {
+            it->pos++;
+            continue;
+        }
+
+        // "%%" - literal, starting from the second "%"
+        if(str[p + 1] == '%') {
+            end = it->lit;
+            it->lit = p + 1;
+            it->pos = p + 2;
+
+            if(p > end) {
+                tok->start = end;
+                tok->len = p - end;
+                tok->arg = 0;
+                return 1;
+            }
+
+            continue;
+        }
+
+        end = __lv_i18n_fmt_parse_spec(str, p + 1, &it->seq, &it->spec);
+
+        if(end == 0) {
+            it->pos++;
+            continue;
+        }
+
+        it->pos = end;
+
+        if(p > it->lit) {
+            tok->start = it->lit;
+            tok->len = p - it->lit;
+            tok->arg = 0;
+            it->has_spec = 1;
+            it->lit = end;
+            return 1;
+        }
+
+        it->lit = end;
+        *tok = it->spec;
+        return 1;
+    }
+
+    if(it->pos > it->lit) {
+        tok->start = it->lit;
+        tok->len = it->pos - it->lit;
+        tok->arg = 0;
+        it->lit = it->pos;
+        return 1;
+    }
+
+    return 0;
+}
+
+// Append text to buffer (as much as fits), returns new length of result
+static size_t __lv_i18n_fmt_put(char * buf, size_t cap, size_t pos, const char * s, size_t len)
+{
+    if(pos < cap) memcpy(buf + pos, s, cap - pos - 1 < len ? cap - pos - 1 : len);
+    return pos + len;
+}
+
+static size_t __lv_i18n_fmt_dec(char * buf, size_t cap, size_t pos, unsigned long val, int neg)
+{
+    char tmp[24];
+    size_t i = sizeof(tmp);
+
+    do {
+        tmp[--i] = (char)('0' + val % 10);
+        val /= 10;
+    } while(val != 0);
+
+    if(neg) tmp[--i] = '-';
+
+    return __lv_i18n_fmt_put(buf, cap, pos, tmp + i, sizeof(tmp) - i);
+}
+
+// Print single argument, returns new length of result
+static size_t __lv_i18n_fmt_arg(char * buf, size_t cap, size_t pos, const char * spec, size_t len, uint8_t type,
+                                const __lv_i18n_fmt_arg_t * arg)
+{
+    char fmt[LV_I18N_FORMAT_MAX_SPEC + 2];
+    char * out = pos < cap ? buf + pos : NULL;
+    size_t room = pos < cap ? cap - pos : 0;
+    int n;
+
+    // Fast path for the most used specs without flags
+    if(len == 1) {
+        if(type == LV_I18N_ARG_STR && arg->s != NULL) {
+            return __lv_i18n_fmt_put(buf, cap, pos, arg->s, strlen(arg->s));
+        }
+        if(type == LV_I18N_ARG_INT && spec[0] != 'c') {
+            return __lv_i18n_fmt_dec(buf, cap, pos, arg->i < 0 ? 0UL - (unsigned long)arg->i : (unsigned long)arg->i,
+                                     arg->i < 0);
+        }
+        if(type == LV_I18N_ARG_UINT && spec[0] == 'u') {
+            return __lv_i18n_fmt_dec(buf, cap, pos, arg->u, 0);
+        }
+    }
+
+    fmt[0] = '%';
+    memcpy(fmt + 1, spec, len);
+    fmt[len + 1] = '\0';
+
+    switch(type) {
+        case LV_I18N_ARG_INT: n = LV_I18N_SNPRINTF(out, room, fmt, arg->i); break;
+        case LV_I18N_ARG_UINT: n = LV_I18N_SNPRINTF(out, room, fmt, arg->u); break;
+        case LV_I18N_ARG_LONG: n = LV_I18N_SNPRINTF(out, room, fmt, arg->l); break;
+        case LV_I18N_ARG_ULONG: n = LV_I18N_SNPRINTF(out, room, fmt, arg->ul); break;
+        case LV_I18N_ARG_LLONG: n = LV_I18N_SNPRINTF(out, room, fmt, arg->ll); break;
+        case LV_I18N_ARG_ULLONG: n = LV_I18N_SNPRINTF(out, room, fmt, arg->ull); break;
+        case LV_I18N_ARG_SIZE: n = LV_I18N_SNPRINTF(out, room, fmt, arg->z); break;
+        case LV_I18N_ARG_DOUBLE: n = LV_I18N_SNPRINTF(out, room, fmt, arg->d); break;
+        case LV_I18N_ARG_STR: n = LV_I18N_SNPRINTF(out, room, fmt, arg->s); break;
+        case LV_I18N_ARG_PTR: n = LV_I18N_SNPRINTF(out, room, fmt, arg->p); break;
+        default: n = 0; break;
+    }
+
+    return pos + (n > 0 ? (size_t)n : 0);
+}
+
+/**
+ * Translation of formatted phrase in base locale
+ * @return translation, NULL if not found
+ */
+static const char * __lv_i18n_fmt_base(const __lv_i18n_fmt_src_t * src)
+{
+    const lv_i18n_ctx_t * ctx = src->ctx;
+    const lv_i18n_lang_t * base;
+#ifdef LV_I18N_BINARY
+    const uint8_t * bin_locale = LV_I18N_ATOMIC_LOAD(&ctx->bin_locale);
+#endif
+
+    if(src->msg_index == LV_I18N_ID_NOT_FOUND) return NULL;
+
+#ifdef LV_I18N_BINARY
+    if(bin_locale != NULL) {
+        const uint8_t * bin = __lv_i18n_bin_of(bin_locale);
+        const uint8_t * locale = __lv_i18n_bin_locale(bin, 0);
+
+        return src->plural ? __lv_i18n_bin_get_plural(bin, locale, NULL, src->msg_index, src->num, NULL) :
+               __lv_i18n_bin_get_singular(bin, locale, NULL, src->msg_index, NULL);
+    }
+#endif
+
+    if(ctx->lang_pack == NULL || ctx->lang_pack[0] == NULL) return NULL;
+    base = ctx->lang_pack[0];
+
+    return src->plural ? __lv_i18n_lang_find_plural(base, NULL, src->msg_index, src->num, NULL) :
+           __lv_i18n_lang_find_singular(base, NULL, src->msg_index, NULL);
+}
+
+// Collect types of arguments, not known yet. Returns max argument number.
+static unsigned __lv_i18n_fmt_types(const char * str, const lv_i18n_fmt_token_t * tokens, uint8_t * types)
+{
+    __lv_i18n_fmt_iter_t it;
+    __lv_i18n_fmt_tok_t tok;
+    unsigned count = 0;
+
+    __lv_i18n_fmt_iter_init(&it, str, tokens);
+
+    while(__lv_i18n_fmt_next(&it, &tok)) {
+        if(tok.arg == 0) continue;
+        if(types[tok.arg - 1] == 0) types[tok.arg - 1] = tok.type;
+        if(tok.arg > count) count = tok.arg;
+    }
+
+    return count;
+}
+
+/**
+ * Format string into buffer
+ * @param tokens pre-parsed format, or NULL to parse `str`
+ * @param src phrase of `str`, to take types of skipped arguments from base
+ *            locale (pre-parsed formats have those already)
+ * @return length of result, as `snprintf()` does
+ */
+static int __lv_i18n_vformat(char * buf, size_t cap, const char * str, const lv_i18n_fmt_token_t * tokens,
+                             const __lv_i18n_fmt_src_t * src, va_list ap)
+{
+    __lv_i18n_fmt_arg_t args[LV_I18N_FORMAT_MAX_ARGS];
+    uint8_t types[LV_I18N_FORMAT_MAX_ARGS];
+    __lv_i18n_fmt_iter_t it;
+    __lv_i18n_fmt_tok_t tok;
+    unsigned i, count;
+    size_t pos = 0;
+
+    // Pre-parsed string without specs
+    if(tokens != NULL && tokens[0].len == 0 && tokens[0].arg == 0) {
+        pos = __lv_i18n_fmt_put(buf, cap, 0, str, strlen(str));
+    }
+    else {
+        memset(types, 0, sizeof(types));
+
+        // Arguments can be used in any order, so collect types first,
+        // to read all from va_list in order
+        count = __lv_i18n_fmt_types(str, tokens, types);
+
+        // Skipped argument ("%2$s" without "%1$d") is still in va_list,
+        // take its type from base locale, as compiler does for tokens
+        if(memchr(types, 0, count) != NULL) {
+            const char * base = __lv_i18n_fmt_base(src);
+
+            if(base != NULL) __lv_i18n_fmt_types(base, NULL, types);
+        }
+
+        for(i = 0; i < count; i++) {
+            switch(types[i]) {
+                case LV_I18N_ARG_INT: args[i].i = va_arg(ap, int); break;
+                case LV_I18N_ARG_UINT: args[i].u = va_arg(ap, unsigned); break;
+                case LV_I18N_ARG_LONG: args[i].l = va_arg(ap, long); break;
+                case LV_I18N_ARG_ULONG: args[i].ul = va_arg(ap, unsigned long); break;
+                case LV_I18N_ARG_LLONG: args[i].ll = va_arg(ap, long long); break;
+                case LV_I18N_ARG_ULLONG: args[i].ull = va_arg(ap, unsigned long long); break;
+                case LV_I18N_ARG_SIZE: args[i].z = va_arg(ap, size_t); break;
+                case LV_I18N_ARG_DOUBLE: args[i].d = va_arg(ap, double); break;
+                case LV_I18N_ARG_STR: args[i].s = va_arg(ap, const char *); break;
+                case LV_I18N_ARG_PTR: args[i].p = va_arg(ap, const void *); break;
+                // Type is unknown in base locale too, can not read next ones
+                default: count = i; break;
+            }
+        }
+
+        __lv_i18n_fmt_iter_init(&it, str, tokens);
+
+        while(__lv_i18n_fmt_next(&it, &tok)) {
+            if(tok.arg == 0) {
+                pos = __lv_i18n_fmt_put(buf, cap, pos, str + tok.start, tok.len);
+            }
+            else if(tok.len != 0 && tok.arg <= count) {
+                pos = __lv_i18n_fmt_arg(buf, cap, pos, str + tok.start, tok.len, tok.type, &args[tok.arg - 1]);
+            }
+        }
+    }
+
+    if(cap > 0) buf[pos < cap ? pos : cap - 1] = '\0';
+
+    return (int)pos;
+}
+
+/**
+ * Translate message and format it into buffer, like `snprintf()`
+ * @param ctx context
+ * @param buf output buffer
+ * @param cap size of buffer
+ * @param msg_index the index of the msg_id
+ * @param msg_id message ID
+ * @return length of result (can be bigger than `cap`, if truncated)
+ */
+int lv_i18n_ctx_format_by_idx(const lv_i18n_ctx_t * ctx, char * buf, size_t cap, int msg_index,
+                              const char * msg_id, ...)
+{
+    __lv_i18n_found_t found = { NULL, LV_I18N_STATS_MISS, NULL };
+    const char * str = __lv_i18n_ctx_singular(ctx, msg_id, msg_index, &found);
+    const __lv_i18n_fmt_src_t src = { ctx, msg_index, 0, 0 };
+    va_list ap;
+    int res;
+
+    va_start(ap, msg_id);
+    res = __lv_i18n_vformat(buf, cap, str, found.fmt, &src, ap);
+    va_end(ap);
+
+    return res;
+}
+
+/**
+ * Translate message with plural rules and format it into buffer
+ * @param ctx context
+ * @param buf output buffer
+ * @param cap size of buffer
+ * @param msg_index the index of the msg_id
+ * @param msg_id message ID
+ * @param num an integer to select the correct plural form (not passed to format)
+ * @return length of result (can be bigger than `cap`, if truncated)
+ */
+int lv_i18n_ctx_format_plural_by_idx(const lv_i18n_ctx_t * ctx, char * buf, size_t cap, int msg_index,
+                                     const char * msg_id, int32_t num, ...)
+{
+    __lv_i18n_found_t found = { NULL, LV_I18N_STATS_MISS, NULL };
+    const char * str = __lv_i18n_ctx_plural(ctx, msg_id, msg_index, num, &found);
+    const __lv_i18n_fmt_src_t src = { ctx, msg_index, 1, num };
+    va_list ap;
+    int res;
+
+    va_start(ap, num);
+    res = __lv_i18n_vformat(buf, cap, str, found.fmt, &src, ap);
+    va_end(ap);
+
+    return res;
+}
+
+/**
+ * Translate message and format it into buffer, in default context
+ */
+int lv_i18n_format_by_idx(char * buf, size_t cap, int msg_index, const char * msg_id, ...)
+{
+    __lv_i18n_found_t found = { NULL, LV_I18N_STATS_MISS, NULL };
+    const char * str = __lv_i18n_ctx_singular(&default_ctx, msg_id, msg_index, &found);
+    const __lv_i18n_fmt_src_t src = { &default_ctx, msg_index, 0, 0 };
+    va_list ap;
+    int res;
+
+    va_start(ap, msg_id);
+    res = __lv_i18n_vformat(buf, cap, str, found.fmt, &src, ap);
+    va_end(ap);
+
+    return res;
+}
+
+/**
+ * Translate message with plural rules and format it into buffer, in default context
+ */
+int lv_i18n_format_plural_by_idx(char * buf, size_t cap, int msg_index, const char * msg_id, int32_t num, ...)
+{
+    __lv_i18n_found_t found = { NULL, LV_I18N_STATS_MISS, NULL };
+    const char * str = __lv_i18n_ctx_plural(&default_ctx, msg_id, msg_index, num, &found);
+    const __lv_i18n_fmt_src_t src = { &default_ctx, msg_index, 1, num };
+    va_list ap;
+    int res;
+
+    va_start(ap, num);
+    res = __lv_i18n_vformat(buf, cap, str, found.fmt, &src, ap);
+    va_end(ap);
+
+    return res;
+}
+
+#ifdef LV_I18N_OPTIMIZE
+// Modern compilers calculate phrase IDs at compile time
+
+#else
+// Fallback for ancient compilers, search phrase IDs in runtime
+
+#ifdef LV_I18N_LINEAR_LOOKUP
+// Linear search (slow), kept for comparison
+
+static int __lv_i18n_get_id(const char * phrase, const char * * list, int len)
+{
+    uint16_t i;
+    for(i = 0; i < len; i++) {
+        if(list[i] != NULL && strcmp(list[i], phrase) == 0) return i;
+    }
+    return LV_I18N_ID_NOT_FOUND;
+}
+
+int lv_i18n_get_singular_id(const char * phrase)
+{
+    return __lv_i18n_get_id(phrase, singular_idx, sizeof(singular_idx) / sizeof(singular_idx[0]));
+}
+
+int lv_i18n_get_plural_id(const char * phrase)
+{
+    return __lv_i18n_get_id(phrase, plural_idx, sizeof(plural_idx) / sizeof(plural_idx[0]));
+}
+
+#else
+// Minimal perfect hash, generated by compiler (see `lib/hash.js`).
+// One hash calculation + one `strcmp()` to verify result.
+
+// FNV-1a
+static uint32_t __lv_i18n_hash(const char * str, uint32_t seed)
+{
+    uint32_t h = 0x811c9dc5u ^ seed;
+    while(*str) {
+        h ^= (uint8_t)*str++;
+        h *= 0x01000193u;
+    }
+    return h;
+}
+
+static int __lv_i18n_get_id(const char * phrase, const char * * list, uint32_t seed,
+                            const int32_t * disp, uint32_t disp_len,
+                            const uint16_t * slots, uint32_t slots_len)
+{
+    uint32_t h = __lv_i18n_hash(phrase, seed);
+    int32_t d = disp[lv_i18n_hash_mix(h, 0) % disp_len];
+    uint32_t slot = d < 0 ? (uint32_t)(-d - 1) : lv_i18n_hash_mix(h, (uint32_t)d) % slots_len;
+    uint16_t idx = slots[slot];
+
+    if(list[idx] != NULL && strcmp(list[idx], phrase) == 0) return idx;
+    return LV_I18N_ID_NOT_FOUND;
+}
+
+#define LV_I18N_HASH_ARGS(name) \
+    name##_hash_seed, \
+    name##_hash_disp, (uint32_t)(sizeof(name##_hash_disp) / sizeof(name##_hash_disp[0])), \
+    name##_hash_slots, (uint32_t)(sizeof(name##_hash_slots) / sizeof(name##_hash_slots[0]))
+
+int lv_i18n_get_singular_id(const char * phrase)
+{
+    return __lv_i18n_get_id(phrase, singular_idx, LV_I18N_HASH_ARGS(singular));
+}
+
+int lv_i18n_get_plural_id(const char * phrase)
+{
+    return __lv_i18n_get_id(phrase, plural_idx, LV_I18N_HASH_ARGS(plural));
+}
+
+#endif
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+/**
+ * Reset internal state. For testing.
+ */
+void __lv_i18n_reset(void)
+{
+    memset(&default_ctx, 0, sizeof(default_ctx));
+    memset(change_subs, 0, sizeof(change_subs));
+    __lv_i18n_ctx_invalidate(&default_ctx);
+#ifdef LV_I18N_COMPRESS
+    memset(decode_cache, 0, sizeof(decode_cache));
+#endif
+}
+
+/**
+ * Set the languages for internationalization in context. Not thread-safe,
+ * should not be called while other threads use this context.
+ * @param ctx context
+ * @param langs pointer to the array of languages. (Last element has to be `NULL`)
+ */
+int lv_i18n_ctx_init(lv_i18n_ctx_t * ctx, const lv_i18n_language_pack_t * langs)
+{
+    if(langs == NULL) return -1;
+    if(langs[0] == NULL) return -1;
+
+#ifdef LV_I18N_BINARY
+    LV_I18N_ATOMIC_STORE(&ctx->bin_locale, NULL);
+#endif
+    ctx->lang_pack = langs;
+    LV_I18N_ATOMIC_STORE(&ctx->lang, langs[0]);     /*Automatically select the first language*/
+    __lv_i18n_ctx_invalidate(ctx);
+    return 0;
+}
+
+/**
+ * Set the languages for internationalization
+ * @param langs pointer to the array of languages. (Last element has to be `NULL`)
+ */
+int lv_i18n_init(const lv_i18n_language_pack_t * langs)
+{
+    return lv_i18n_ctx_init(&default_ctx, langs);
+}
+
+/**
+ * Sugar for simplified `lv_i18n_init` call
+ */
+int lv_i18n_init_default(void)
+{
+    return lv_i18n_init(lv_i18n_language_pack);
+}
+
+#ifdef LV_I18N_SPLIT
+/**
+ * Add locale from separate file (`--split` mode) to compiled language pack.
+ * Pack is kept in locale ID order, so base locale stays the first one.
+ * @param lang locale, `&lv_i18n_lang_de_de`
+ * @return 0 on success, -1 if locale is unknown or compiled for other phrase IDs
+ */
+int lv_i18n_register_lang(const lv_i18n_lang_t * lang)
+{
+    uint32_t id;
+    uint32_t pos = 0;
+
+    if(lang == NULL || lang->keys_hash != LV_I18N_KEYS_HASH) return -1;
+
+    for(id = 0; id < LV_I18N_LOCALE_COUNT; id++) {
+        if(strcmp(lv_i18n_locale_names[id], lang->locale_name) == 0) break;
+    }
+
+    if(id == LV_I18N_LOCALE_COUNT) return -1;
+
+    // Base locale is used for fallbacks, must be available first
+    if(id != 0 && lv_i18n_registry[0] == NULL) return -1;
+
+    lv_i18n_registry[id] = lang;
+
+    for(id = 0; id < LV_I18N_LOCALE_COUNT; id++) {
+        if(lv_i18n_registry[id] != NULL) lv_i18n_language_pack[pos++] = lv_i18n_registry[id];
+    }
+    lv_i18n_language_pack[pos] = NULL;
+
+    return 0;
+}
+#endif
+
+// Locale names are compared ignoring case and `_` / `-` difference
+static int __lv_i18n_locale_char(char c)
+{
+    if(c == '_') return '-';
+    if(c >= 'A' && c <= 'Z') return c - 'A' + 'a';
+    return (unsigned char)c;
+}
+
+// Compare first `len` chars of `tag` with locale name, like `strcmp()`
+static int __lv_i18n_locale_cmp(const char * tag, size_t len, const char * name)
+{
+    size_t i;
+
+    for(i = 0; i < len; i++) {
+        int diff = __lv_i18n_locale_char(tag[i]) - __lv_i18n_locale_char(name[i]);
+        if(diff != 0) return diff;
+    }
+
+    return name[len] == '\0' ? 0 : -1;
+}
+
+// Length of language subtag ("en" for "en-GB")
+static size_t __lv_i18n_locale_lang_len(const char * tag, size_t len)
+{
+    size_t i = 0;
+
+    while(i < len && tag[i] != '-' && tag[i] != '_') i++;
+    return i;
+}
+
+// Check if locale name has the same language subtag
+static int __lv_i18n_locale_lang_eq(const char * tag, size_t lang_len, const char * name)
+{
+    size_t i;
+
+    for(i = 0; i < lang_len; i++) {
+        if(__lv_i18n_locale_char(tag[i]) != __lv_i18n_locale_char(name[i])) return 0;
+    }
+
+    return name[i] == '\0' || name[i] == '-' || name[i] == '_';
+}
+
+#ifndef LV_I18N_SPLIT
+
+// First position in sorted index of compiled locales, with name >= tag
+static uint32_t __lv_i18n_locale_lower_bound(const char * tag, size_t len)
+{
+    uint32_t lo = 0;
+    uint32_t hi = LV_I18N_LOCALE_COUNT;
+
+    while(lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        const char * name = lv_i18n_language_pack[lv_i18n_locale_order[mid]]->locale_name;
+
+        if(__lv_i18n_locale_cmp(tag, len, name) > 0) lo = mid + 1;
+        else hi = mid;
+    }
+
+    return lo;
+}
+
+#endif
+
+// Check if context uses compiled language pack, with sorted index
+static int __lv_i18n_ctx_is_compiled(const lv_i18n_ctx_t * ctx)
+{
+#ifdef LV_I18N_BINARY
+    if(ctx->bin_locale != NULL) return 0;
+#endif
+    return ctx->lang_pack == lv_i18n_language_pack;
+}
+
+// Name of locale at `pos` in context, NULL after the last one. Must be called
+// with increasing `pos`, because language pack size is not known.
+static const char * __lv_i18n_ctx_locale_name(const lv_i18n_ctx_t * ctx, uint32_t pos)
+{
+#ifdef LV_I18N_BINARY
+    if(ctx->bin_locale != NULL) {
+        const uint8_t * bin = __lv_i18n_bin_of(ctx->bin_locale);
+
+        if(pos >= __lv_i18n_rd16(bin + 24)) return NULL;
+        return __lv_i18n_bin_locale_name(bin, __lv_i18n_bin_locale(bin, pos));
+    }
+#endif
+
+    if(ctx->lang_pack == NULL || ctx->lang_pack[pos] == NULL) return NULL;
+    return ctx->lang_pack[pos]->locale_name;
+}
+
+/**
+ * Find locale of context by name. Exact match wins, else the first locale
+ * with the same language is used ("ru" => "ru-RU", "de-AT" => "de-DE").
+ * @param ctx context
+ * @param tag locale name, not NULL-terminated
+ * @param len length of name
+ * @return position of locale in context, or -1 if not found
+ */
+static int32_t __lv_i18n_ctx_find_locale(const lv_i18n_ctx_t * ctx, const char * tag, size_t len)
+{
+    size_t lang_len = __lv_i18n_locale_lang_len(tag, len);
+    const char * name;
+    int32_t found = -1;
+    uint32_t pos;
+
+    if(len == 0) return -1;
+
+#ifndef LV_I18N_SPLIT
+    // Compiled translations - use sorted index
+    if(__lv_i18n_ctx_is_compiled(ctx)) {
+        pos = __lv_i18n_locale_lower_bound(tag, len);
+
+        if(pos < LV_I18N_LOCALE_COUNT &&
+           __lv_i18n_locale_cmp(tag, len, lv_i18n_language_pack[lv_i18n_locale_order[pos]]->locale_name) == 0) {
+            return lv_i18n_locale_order[pos];
+        }
+
+        // All names with the same language follow the language itself
+        pos = __lv_i18n_locale_lower_bound(tag, lang_len);
+
+        if(pos < LV_I18N_LOCALE_COUNT &&
+           __lv_i18n_locale_lang_eq(tag, lang_len, lv_i18n_language_pack[lv_i18n_locale_order[pos]]->locale_name)) {
+            return lv_i18n_locale_order[pos];
+        }
+
+        return -1;
+    }
+#endif
+
+    // Custom language packs & binary packs - linear search
+    for(pos = 0; (name = __lv_i18n_ctx_locale_name(ctx, pos)) != NULL; pos++) {
+        if(__lv_i18n_locale_cmp(tag, len, name) == 0) return (int32_t)pos;
+        if(found < 0 && __lv_i18n_locale_lang_eq(tag, lang_len, name)) found = (int32_t)pos;
+    }
+
+    return found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Locale change callbacks
+
+#ifdef LV_I18N_LOCALE_DIFF
+// Changed phrases between compiled locales, NULL if nothing changed. Must be
+// in sync with `pair_index()` in `lib/locale_diff.js`.
+static const uint8_t * __lv_i18n_locale_diff(uint32_t a, uint32_t b)
+{
+    uint32_t tmp;
+
+    if(a > b) {
+        tmp = a;
+        a = b;
+        b = tmp;
+    }
+
+    return lv_i18n_locale_diff[a * (2 * LV_I18N_LOCALE_COUNT - a - 1) / 2 + (b - a - 1)];
+}
+#endif
+
+// Call subscribers after locale switch. Diff is known only for compiled
+// language pack, where base locale (for fallbacks) is the same.
+static void __lv_i18n_ctx_notify(const lv_i18n_ctx_t * ctx, const char * old_locale, const lv_i18n_lang_t * old_lang)
+{
+    lv_i18n_locale_change_t change;
+    uint32_t i;
+
+    __lv_i18n_ctx_invalidate(ctx);
+
+    change.ctx = ctx;
+    change.old_locale = old_locale;
+    change.new_locale = lv_i18n_ctx_get_current_locale(ctx);
+    change.diff = NULL;
+    change.all = 1;
+
+#ifdef LV_I18N_LOCALE_DIFF
+    if(old_lang != NULL && __lv_i18n_ctx_is_compiled(ctx)) {
+        uint32_t a = __lv_i18n_compiled_id(old_lang);
+        uint32_t b = __lv_i18n_compiled_id(ctx->lang);
+
+        if(a < LV_I18N_LOCALE_COUNT && b < LV_I18N_LOCALE_COUNT) {
+            change.diff = __lv_i18n_locale_diff(a, b);
+            change.all = 0;
+        }
+    }
+#else
+    (void)old_lang;
+#endif
+
+    for(i = 0; i < LV_I18N_LOCALE_CHANGE_CB_MAX; i++) {
+        if(change_subs[i].cb != NULL) change_subs[i].cb(&change, change_subs[i].user_data);
+    }
+}
+
+/**
+ * Subscribe to locale switches of all contexts
+ * @param cb callback
+ * @param user_data passed to callback as is
+ * @return 0 on success, -1 if no free slots
+ */
+int lv_i18n_add_locale_change_cb(lv_i18n_locale_change_cb_t cb, void * user_data)
+{
+    uint32_t i;
+
+    if(cb == NULL) return -1;
+
+    for(i = 0; i < LV_I18N_LOCALE_CHANGE_CB_MAX; i++) {
+        if(change_subs[i].cb == NULL) {
+            change_subs[i].cb = cb;
+            change_subs[i].user_data = user_data;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Unsubscribe callback, added with the same `user_data`
+ * @return 0 on success, -1 if not found
+ */
+int lv_i18n_remove_locale_change_cb(lv_i18n_locale_change_cb_t cb, void * user_data)
+{
+    uint32_t i;
+
+    for(i = 0; i < LV_I18N_LOCALE_CHANGE_CB_MAX; i++) {
+        if(change_subs[i].cb == cb && change_subs[i].user_data == user_data) {
+            change_subs[i].cb = NULL;
+            change_subs[i].user_data = NULL;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+static int __lv_i18n_is_changed(const lv_i18n_locale_change_t * change, int msg_index, uint32_t bit)
+{
+    // Unknown phrases are shown as is in all locales
+    if(msg_index == LV_I18N_ID_NOT_FOUND) return 0;
+    if(change->all) return 1;
+    if(change->diff == NULL) return 0;
+
+    return (change->diff[bit >> 3] >> (bit & 7)) & 1;
+}
+
+/**
+ * Check if text of singular phrase can differ after locale switch
+ * @param change locale switch, passed to callback
+ * @param msg_index the index of the msg_id
+ * @return 1 if text can be changed, 0 if it is the same
+ */
+int lv_i18n_is_singular_changed_by_idx(const lv_i18n_locale_change_t * change, int msg_index)
+{
+    return __lv_i18n_is_changed(change, msg_index, (uint32_t)msg_index);
+}
+
+/**
+ * Check if text of plural phrase (any form) can differ after locale switch
+ */
+int lv_i18n_is_plural_changed_by_idx(const lv_i18n_locale_change_t * change, int msg_index)
+{
+    return __lv_i18n_is_changed(change, msg_index, LV_I18N_SINGULAR_COUNT + (uint32_t)msg_index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Switch context to locale of language pack, and call subscribers if changed
+static void __lv_i18n_ctx_set_lang(lv_i18n_ctx_t * ctx, const lv_i18n_lang_t * lang)
+{
+    const lv_i18n_lang_t * old_lang = ctx->lang;
+
+    if(lang == old_lang) return;
+
+    LV_I18N_ATOMIC_STORE(&ctx->lang, lang);
+    __lv_i18n_ctx_notify(ctx, old_lang != NULL ? old_lang->locale_name : NULL, old_lang);
+}
+
+// Switch context to locale at position, found by `__lv_i18n_ctx_find_locale()`
+static void __lv_i18n_ctx_set_locale_pos(lv_i18n_ctx_t * ctx, int32_t pos)
+{
+#ifdef LV_I18N_BINARY
+    if(ctx->bin_locale != NULL) {
+        const uint8_t * old_locale = ctx->bin_locale;
+        const uint8_t * bin = __lv_i18n_bin_of(old_locale);
+        const uint8_t * locale = __lv_i18n_bin_locale(bin, (uint32_t)pos);
+
+        if(locale == old_locale) return;
+
+        LV_I18N_ATOMIC_STORE(&ctx->bin_locale, locale);
+        __lv_i18n_ctx_notify(ctx, __lv_i18n_bin_locale_name(bin, old_locale), NULL);
+        return;
+    }
+#endif
+
+    __lv_i18n_ctx_set_lang(ctx, ctx->lang_pack[pos]);
+}
+
+/**
+ * Change the localization (language) of context. Safe to call while other
+ * threads get translations from this context.
+ * @param ctx context
+ * @param l_name name of the translation locale to use. E.g. "en-GB"
+ */
+int lv_i18n_ctx_set_locale(lv_i18n_ctx_t * ctx, const char * l_name)
+{
+    int32_t pos;
+
+    if(l_name == NULL) return -1;
+
+    pos = __lv_i18n_ctx_find_locale(ctx, l_name, strlen(l_name));
+
+    if(pos < 0) return -1;
+
+    __lv_i18n_ctx_set_locale_pos(ctx, pos);
+    return 0;
+}
+
+/**
+ * Change the localization (language)
+ * @param l_name name of the translation locale to use. E.g. "en-GB"
+ */
+int lv_i18n_set_locale(const char * l_name)
+{
+    return lv_i18n_ctx_set_locale(&default_ctx, l_name);
+}
+
+/**
+ * Change the localization of context by compiled locale ID
+ * @param ctx context
+ * @param locale locale ID, `LV_I18N_LOCALE_EN_GB`
+ */
+int lv_i18n_ctx_set_locale_by_idx(lv_i18n_ctx_t * ctx, lv_i18n_locale_t locale)
+{
+    if((uint32_t)locale >= (uint32_t)LV_I18N_LOCALE_COUNT) return -1;
+
+    if(__lv_i18n_ctx_is_compiled(ctx)) {
+        const lv_i18n_lang_t * lang = LV_I18N_COMPILED_LANG(locale);
+
+        if(lang == NULL) return -1; // not registered
+
+        __lv_i18n_ctx_set_lang(ctx, lang);
+        return 0;
+    }
+
+    // Other packs can have different locales order
+    return lv_i18n_ctx_set_locale(ctx, LV_I18N_COMPILED_NAME(locale));
+}
+
+/**
+ * Change the localization (language) by compiled locale ID
+ * @param locale locale ID, `LV_I18N_LOCALE_EN_GB`
+ */
+int lv_i18n_set_locale_by_idx(lv_i18n_locale_t locale)
+{
+    return lv_i18n_ctx_set_locale_by_idx(&default_ctx, locale);
+}
+
+// Parse quality value ("1", "0.8", "0.125") to 0..1000
+static uint32_t __lv_i18n_parse_q(const char * str)
+{
+    uint32_t q = 0;
+    uint32_t scale = 1000;
+
+    if(*str == '1') return 1000;
+    if(*str != '0') return 0;
+
+    if(str[1] != '.') return 0;
+
+    for(str += 2; scale > 1 && *str >= '0' && *str <= '9'; str++) {
+        scale /= 10;
+        q += (uint32_t)(*str - '0') * scale;
+    }
+
+    return q;
+}
+
+/**
+ * Select the best locale of context for priority list, in `Accept-Language`
+ * format ("de-CH, de;q=0.9, en;q=0.5, *;q=0.1"). Locales are matched the same
+ * way as in `lv_i18n_ctx_set_locale()`. From equal `q` the first one wins.
+ * @param ctx context
+ * @param accept_list list of locales
+ * @return 0 on success, -1 if nothing matched (locale is not changed)
+ */
+int lv_i18n_ctx_set_locale_best_match(lv_i18n_ctx_t * ctx, const char * accept_list)
+{
+    const char * p = accept_list;
+    int32_t best = -1;
+    uint32_t best_q = 0;
+
+    if(p == NULL) return -1;
+
+    while(*p != '\0') {
+        const char * tag;
+        size_t len;
+        uint32_t q = 1000;
+        int32_t pos;
+
+        while(*p == ' ' || *p == ',') p++;
+
+        tag = p;
+        while(*p != '\0' && *p != ',' && *p != ';' && *p != ' ') p++;
+        len = (size_t)(p - tag);
+
+        // Parameters, only `q` is used
+        while(*p == ' ') p++;
+        while(*p == ';') {
+            p++;
+            while(*p == ' ') p++;
+            if(p[0] == 'q' && p[1] == '=') q = __lv_i18n_parse_q(p + 2);
+            while(*p != '\0' && *p != ',' && *p != ';') p++;
+        }
+        while(*p != '\0' && *p != ',') p++;
+
+        if(q <= best_q || len == 0) continue;
+
+        if(len == 1 && *tag == '*') {
+            pos = __lv_i18n_ctx_locale_name(ctx, 0) != NULL ? 0 : -1;
+        } else {
+            pos = __lv_i18n_ctx_find_locale(ctx, tag, len);
+        }
+
+        if(pos >= 0) {
+            best = pos;
+            best_q = q;
+        }
+    }
+
+    if(best < 0) return -1;
+
+    __lv_i18n_ctx_set_locale_pos(ctx, best);
+    return 0;
+}
+
+/**
+ * Select the best locale for priority list, in `Accept-Language` format
+ * @param accept_list list of locales, "de-CH, de;q=0.9, en;q=0.5"
+ */
+int lv_i18n_set_locale_best_match(const char * accept_list)
+{
+    return lv_i18n_ctx_set_locale_best_match(&default_ctx, accept_list);
+}
+
+/**
+ * Get the name of the locale, currently used in context.
+ * @param ctx context
+ * @return name of the currently used locale. E.g. "en-GB"
+ */
+const char * lv_i18n_ctx_get_current_locale(const lv_i18n_ctx_t * ctx)
+{
+    const lv_i18n_lang_t * lang;
+#ifdef LV_I18N_BINARY
+    const uint8_t * bin_locale = LV_I18N_ATOMIC_LOAD(&ctx->bin_locale);
+
+    if(bin_locale != NULL) return __lv_i18n_bin_locale_name(__lv_i18n_bin_of(bin_locale), bin_locale);
+#endif
+
+    lang = LV_I18N_ATOMIC_LOAD(&ctx->lang);
+
+    if(!lang) return NULL;
+    return lang->locale_name;
 }
 
 /**
@@ -302,6 +2418,5 @@ int lv_i18n_set_locale(const char * l_name)
  */
 const char * lv_i18n_get_current_locale(void)
 {
-    if(!current_lang) return NULL;
-    return current_lang->locale_name;
+    return lv_i18n_ctx_get_current_locale(&default_ctx);
 }
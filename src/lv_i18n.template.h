@@ -8,7 +8,19 @@ extern "C" {
 #include <stdint.h>
 #include <string.h>
 
-////////////////////////////////////////////////////////////////////////////////
+/*SAMPLE_START*/
+#undef LV_I18N_OPTIMIZE
+typedef enum {
+    LV_I18N_LOCALE_EN_GB = 0,
+    LV_I18N_LOCALE_RU_RU = 1,
+    LV_I18N_LOCALE_DE_DE = 2,
+    LV_I18N_LOCALE_COUNT = 3
+} lv_i18n_locale_t;
+
+#define LV_I18N_SINGULAR_COUNT 4
+#define LV_I18N_PLURAL_COUNT 1
+
+/*SAMPLE_END*/
 
 typedef enum {
     LV_I18N_PLURAL_TYPE_ZERO,
@@ -20,26 +32,137 @@ typedef enum {
     _LV_I18N_PLURAL_TYPE_NUM,
 } lv_i18n_plural_type_t;
 
+#ifdef LV_I18N_PLURAL_TABLE
+// Plural rule as data (see `--plural-table` option). Forms of small numbers
+// are taken from table, other numbers are evaluated via bytecode.
+typedef struct {
+    const uint8_t * forms;
+    const uint8_t * code;
+    uint16_t forms_size;
+    uint16_t code_size;
+} lv_i18n_plural_rule_t;
+#endif
+
+// Pre-parsed format string token (see `--format-tokens` option):
+// literal text or argument spec, addressed by offset in string.
+// Last token is all zeros.
+typedef struct {
+    uint16_t start;
+    uint16_t len;
+    uint8_t arg;    // 1-based argument number, 0 for literal
+    uint8_t type;   // argument type, LV_I18N_ARG_*
+} lv_i18n_fmt_token_t;
+
+// Precomputed string metadata (see `--string-info` option)
+typedef struct {
+    uint16_t len;   // length in bytes, without '\0'
+    uint16_t chars; // number of UTF-8 code points
+    uint32_t hash;  // FNV-1a of bytes
+} lv_i18n_str_info_t;
+
+#ifdef LV_I18N_STRING_POOL
+
+// Translations are stored in single blob and addressed by offsets
+// (see `--string-pool` option). Zero offset = NULL.
+typedef struct {
+    const char * locale_name;
+    const char * pool;
+    const lv_i18n_pool_offset_t * singulars;
+    const lv_i18n_pool_offset_t * plurals[_LV_I18N_PLURAL_TYPE_NUM];
+    const uint8_t * plural_fallback; // bit per plural key to take from base locale (or NULL)
+    uint8_t (*locale_plural_fn)(int32_t num);
+#ifdef LV_I18N_PLURAL_TABLE
+    const lv_i18n_plural_rule_t * plural_rule; // used if `locale_plural_fn` not set
+#endif
+#ifdef LV_I18N_FORMAT_TOKENS
+    const lv_i18n_fmt_token_t * const * singular_fmts;
+    const lv_i18n_fmt_token_t * const * plural_fmts[_LV_I18N_PLURAL_TYPE_NUM];
+#endif
+#ifdef LV_I18N_STRING_INFO
+    const lv_i18n_str_info_t * singular_info;
+    const lv_i18n_str_info_t * plural_info[_LV_I18N_PLURAL_TYPE_NUM];
+#endif
+#ifdef LV_I18N_SPLIT
+    uint32_t keys_hash; // phrase IDs version, checked on register
+#endif
+#ifdef LV_I18N_RESOLVED_FALLBACK
+    uint8_t resolved; // singular fallbacks baked into tables (set by compiler)
+#endif
+} lv_i18n_lang_t;
+
+#else
+
 typedef struct {
     const char * locale_name;
     const char * * singulars;
     const char * * plurals[_LV_I18N_PLURAL_TYPE_NUM];
+    const uint8_t * plural_fallback; // bit per plural key to take from base locale (or NULL)
     uint8_t (*locale_plural_fn)(int32_t num);
+#ifdef LV_I18N_PLURAL_TABLE
+    const lv_i18n_plural_rule_t * plural_rule; // used if `locale_plural_fn` not set
+#endif
+#ifdef LV_I18N_FORMAT_TOKENS
+    const lv_i18n_fmt_token_t * const * singular_fmts;
+    const lv_i18n_fmt_token_t * const * plural_fmts[_LV_I18N_PLURAL_TYPE_NUM];
+#endif
+#ifdef LV_I18N_STRING_INFO
+    const lv_i18n_str_info_t * singular_info;
+    const lv_i18n_str_info_t * plural_info[_LV_I18N_PLURAL_TYPE_NUM];
+#endif
+#ifdef LV_I18N_SPLIT
+    uint32_t keys_hash; // phrase IDs version, checked on register
+#endif
+#ifdef LV_I18N_RESOLVED_FALLBACK
+    uint8_t resolved; // singular fallbacks baked into tables (set by compiler)
+#endif
 } lv_i18n_lang_t;
 
+#endif
+
+// Placement of strings with `--profile` option: used in profiled run (hot)
+// and the rest (cold). Define as section attributes to put hot strings into
+// fast memory, `__attribute__((section(".fast_rodata")))` for example.
+#ifndef LV_I18N_HOT_SECTION
+#define LV_I18N_HOT_SECTION
+#endif
+#ifndef LV_I18N_COLD_SECTION
+#define LV_I18N_COLD_SECTION
+#endif
+
 #define LV_I18N_ID_NOT_FOUND 0xFFFF
 
 // Null-terminated list of languages. First one used as default.
 typedef const lv_i18n_lang_t * lv_i18n_language_pack_t;
 
+#ifdef LV_I18N_SPLIT
+
+// Registered locales (see `lv_i18n_register_lang()`)
+extern lv_i18n_language_pack_t lv_i18n_language_pack[];
+
+// Locales of `--split` mode, each in own file: `lv_i18n_lang_en_gb`, ...
+#define LV_I18N_LANG_EXTERN(loc) extern const lv_i18n_lang_t lv_i18n_lang_ ## loc;
+LV_I18N_SPLIT_LOCALES(LV_I18N_LANG_EXTERN)
+
+#else
+
 extern const lv_i18n_language_pack_t lv_i18n_language_pack[];
 
-/*SAMPLE_START*/
-#undef LV_I18N_OPTIMIZE
-#define LV_I18N_IDX_s(str) (!strcmp(str, "s_en_only")?0:(!strcmp(str, "s_translated")?1:(!strcmp(str, "s_untranslated")?2:LV_I18N_ID_NOT_FOUND)))
-#define LV_I18N_IDX_p(str) (!strcmp(str, "p_i_have_dogs")?0:LV_I18N_ID_NOT_FOUND)
+#endif
 
-/*SAMPLE_END*/
+// Translation state. Locale switch is a single pointer store, so one thread
+// can change locale while others get translations from the same context.
+typedef struct {
+    const lv_i18n_language_pack_t * lang_pack;
+    const lv_i18n_lang_t * volatile lang;
+#ifdef LV_I18N_BINARY
+    const uint8_t * volatile bin_locale; // record of current locale in binary pack
+#endif
+} lv_i18n_ctx_t;
+
+// With `--compress`, translations are decoded into per-thread cache of
+// LV_I18N_DECODE_CACHE_SIZE strings (8 by default). Returned pointer stays
+// valid until that many other translations are looked up by the same
+// thread, copy the string to keep it longer or pass it to other threads.
 
 /**
  * Get the translation from a message ID
@@ -58,10 +181,66 @@ const char * lv_i18n_get_singular_by_idx(const char * msg_id, int msg_index);
  */
 const char * lv_i18n_get_plural_by_idx(const char * msg_id, int msg_index, int32_t num);
 
+/**
+ * Same as `lv_i18n_get_singular_by_idx()`, for given context
+ */
+const char * lv_i18n_ctx_get_singular_by_idx(const lv_i18n_ctx_t * ctx, const char * msg_id, int msg_index);
+
+/**
+ * Same as `lv_i18n_get_plural_by_idx()`, for given context
+ */
+const char * lv_i18n_ctx_get_plural_by_idx(const lv_i18n_ctx_t * ctx, const char * msg_id, int msg_index,
+                                           int32_t num);
+
+#if defined(__GNUC__)
+#define LV_I18N_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define LV_I18N_ALWAYS_INLINE inline
+#endif
+
+// Murmur3 finalizer, used for perfect hash lookup of phrase IDs
+static LV_I18N_ALWAYS_INLINE uint32_t lv_i18n_hash_mix(uint32_t h, uint32_t d)
+{
+    h ^= d;
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
 #ifdef LV_I18N_OPTIMIZE
 
+// Resolve string literal hash to phrase ID via perfect hash. Hash can
+// collide for unknown literal, so key is compared too. For string literals
+// everything (`memcmp()` too) is folded to constant by compiler, if inlined.
+static LV_I18N_ALWAYS_INLINE int lv_i18n_idx_find(const char * str, size_t size, uint32_t h, const int32_t * disp,
+                                                  uint32_t disp_len, const uint16_t * slots,
+                                                  const uint32_t * hashes, const char * const * keys, uint32_t len)
+{
+    int32_t d;
+    uint32_t slot;
+    uint16_t idx;
+
+    if(len == 0) return LV_I18N_ID_NOT_FOUND;
+
+    d = disp[lv_i18n_hash_mix(h, 0) % disp_len];
+    slot = d < 0 ? (uint32_t)(-d - 1) : lv_i18n_hash_mix(h, (uint32_t)d) % len;
+    idx = slots[slot];
+
+    if(hashes[idx] != h || strlen(keys[idx]) + 1 != size || memcmp(keys[idx], str, size) != 0) {
+        return LV_I18N_ID_NOT_FOUND;
+    }
+    return idx;
+}
+
 #define _(text) lv_i18n_get_singular_by_idx(text, LV_I18N_IDX_s(text))
 #define _p(text, num) lv_i18n_get_plural_by_idx(text, LV_I18N_IDX_p(text), num)
+#define _c(ctx, text) lv_i18n_ctx_get_singular_by_idx(ctx, text, LV_I18N_IDX_s(text))
+#define _cp(ctx, text, num) lv_i18n_ctx_get_plural_by_idx(ctx, text, LV_I18N_IDX_p(text), num)
+#define LV_I18N_ID_s(text) LV_I18N_IDX_s(text)
+#define LV_I18N_ID_p(text) LV_I18N_IDX_p(text)
 
 #else
 
@@ -70,9 +249,182 @@ int lv_i18n_get_plural_id(const char * phrase);
 
 #define _(text) lv_i18n_get_singular_by_idx(text, lv_i18n_get_singular_id(text))
 #define _p(text, num) lv_i18n_get_plural_by_idx(text, lv_i18n_get_plural_id(text), num)
+#define _c(ctx, text) lv_i18n_ctx_get_singular_by_idx(ctx, text, lv_i18n_get_singular_id(text))
+#define _cp(ctx, text, num) lv_i18n_ctx_get_plural_by_idx(ctx, text, lv_i18n_get_plural_id(text), num)
+#define LV_I18N_ID_s(text) lv_i18n_get_singular_id(text)
+#define LV_I18N_ID_p(text) lv_i18n_get_plural_id(text)
 
 #endif
 
+#if defined(__GNUC__) && !defined(LV_I18N_COMPRESS)
+
+// Per-call-site cache of `_()` results. Entry is resolved pointer with
+// locale generation of default context, bumped by every locale switch.
+// Entry is guarded by sequence counter (seqlock), odd while entry is
+// written. Readers never wait: entry, being written, is a miss. Writers do
+// not wait too: if another thread writes the same entry, cache is not
+// updated. So a hit always gives pointer with its own generation.
+typedef struct {
+    const char * str;
+    uintptr_t gen;      // generation of `str`, 0 for empty entry
+    uint32_t seq;
+} lv_i18n_cache_t;
+
+extern volatile uintptr_t lv_i18n_generation;
+
+/**
+ * Get translation via `lv_i18n_get_singular_by_idx()` and store it in cache
+ */
+const char * lv_i18n_cache_fill(lv_i18n_cache_t * cache, const char * msg_id, int msg_index);
+
+// Cached translation, or NULL if locale changed since cache fill
+static LV_I18N_ALWAYS_INLINE const char * lv_i18n_cache_get(const lv_i18n_cache_t * cache)
+{
+    uint32_t seq = __atomic_load_n(&cache->seq, __ATOMIC_ACQUIRE);
+    const char * str = __atomic_load_n(&cache->str, __ATOMIC_RELAXED);
+    uintptr_t gen = __atomic_load_n(&cache->gen, __ATOMIC_RELAXED);
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if((seq & 1) != 0 || __atomic_load_n(&cache->seq, __ATOMIC_RELAXED) != seq) return NULL;
+
+    return gen == __atomic_load_n(&lv_i18n_generation, __ATOMIC_ACQUIRE) ? str : NULL;
+}
+
+#endif
+
+// Same as `_()`, with static cache per call site. Needs statement
+// expressions (GCC, Clang), falls back to `_()` on other compilers and
+// with `--compress`, where decoded strings are recycled. Cache hits are not
+// counted in `LV_I18N_STATS` mode. Define `LV_I18N_INLINE_CACHE` to use it
+// for all `_()` calls.
+#if defined(__GNUC__) && !defined(LV_I18N_COMPRESS)
+#define _i(text) __extension__({ \
+        static lv_i18n_cache_t lv_i18n_cache_; \
+        const char * lv_i18n_str_ = lv_i18n_cache_get(&lv_i18n_cache_); \
+        lv_i18n_str_ != NULL ? lv_i18n_str_ : lv_i18n_cache_fill(&lv_i18n_cache_, text, LV_I18N_ID_s(text)); \
+    })
+
+#ifdef LV_I18N_INLINE_CACHE
+#undef _
+#define _(text) _i(text)
+#endif
+#else
+#define _i(text) _(text)
+#endif
+
+#ifndef LV_I18N_COMPRESS
+
+/**
+ * Get translations of `n` singular phrases by indexes in one pass. Locale
+ * and fallback are chosen once for all. Not translated phrases give NULL.
+ * With `-s` & `--screens` options, compiler writes index lists of phrases,
+ * used by each source file (`LV_I18N_SCREEN_SINGULARS_<file>`).
+ * Not available with `--compress`, where decoded strings are recycled.
+ * @return number of not translated phrases
+ */
+size_t lv_i18n_get_singular_batch(const uint16_t * idx, size_t n, const char ** out);
+
+/**
+ * Same as `lv_i18n_get_singular_batch()`, for plurals, `num[i]` selects
+ * form of `idx[i]` phrase
+ */
+size_t lv_i18n_get_plural_batch(const uint16_t * idx, const int32_t * num, size_t n, const char ** out);
+
+/**
+ * Same as `lv_i18n_get_singular_batch()`, for given context
+ */
+size_t lv_i18n_ctx_get_singular_batch(const lv_i18n_ctx_t * ctx, const uint16_t * idx, size_t n, const char ** out);
+
+/**
+ * Same as `lv_i18n_get_plural_batch()`, for given context
+ */
+size_t lv_i18n_ctx_get_plural_batch(const lv_i18n_ctx_t * ctx, const uint16_t * idx, const int32_t * num, size_t n,
+                                    const char ** out);
+
+#endif
+
+/**
+ * Translate message and format it into buffer, like `snprintf()`. Never
+ * allocates memory. Translations can reorder arguments ("%2$s: %1$d").
+ * @param buf output buffer
+ * @param cap size of buffer
+ * @param msg_index the index of the msg_id
+ * @param msg_id message ID
+ * @return length of result (can be bigger than `cap`, if truncated)
+ */
+int lv_i18n_format_by_idx(char * buf, size_t cap, int msg_index, const char * msg_id, ...);
+
+/**
+ * Same as `lv_i18n_format_by_idx()`, with plural form for `num`.
+ * Note, `num` is not passed to format, pass it again as argument if needed.
+ */
+int lv_i18n_format_plural_by_idx(char * buf, size_t cap, int msg_index, const char * msg_id, int32_t num, ...);
+
+/**
+ * Same as `lv_i18n_format_by_idx()`, for given context
+ */
+int lv_i18n_ctx_format_by_idx(const lv_i18n_ctx_t * ctx, char * buf, size_t cap, int msg_index,
+                              const char * msg_id, ...);
+
+/**
+ * Same as `lv_i18n_format_plural_by_idx()`, for given context
+ */
+int lv_i18n_ctx_format_plural_by_idx(const lv_i18n_ctx_t * ctx, char * buf, size_t cap, int msg_index,
+                                     const char * msg_id, int32_t num, ...);
+
+// First of variadic macro arguments (C99 requires at least one more)
+#define LV_I18N_FIRST(...) LV_I18N_FIRST_(__VA_ARGS__, 0)
+#define LV_I18N_FIRST_(first, ...) first
+
+// lv_i18n_format(buf, cap, "key", args...)
+#define lv_i18n_format(buf, cap, ...) \
+    lv_i18n_format_by_idx(buf, cap, LV_I18N_ID_s(LV_I18N_FIRST(__VA_ARGS__)), __VA_ARGS__)
+// lv_i18n_format_plural(buf, cap, "key", num, args...)
+#define lv_i18n_format_plural(buf, cap, ...) \
+    lv_i18n_format_plural_by_idx(buf, cap, LV_I18N_ID_p(LV_I18N_FIRST(__VA_ARGS__)), __VA_ARGS__)
+#define lv_i18n_ctx_format(ctx, buf, cap, ...) \
+    lv_i18n_ctx_format_by_idx(ctx, buf, cap, LV_I18N_ID_s(LV_I18N_FIRST(__VA_ARGS__)), __VA_ARGS__)
+#define lv_i18n_ctx_format_plural(ctx, buf, cap, ...) \
+    lv_i18n_ctx_format_plural_by_idx(ctx, buf, cap, LV_I18N_ID_p(LV_I18N_FIRST(__VA_ARGS__)), __VA_ARGS__)
+
+#ifdef LV_I18N_STRING_INFO
+/**
+ * Same as `lv_i18n_get_singular_by_idx()`, and get metadata of result:
+ * precomputed by `--string-info` option, or calculated for not translated
+ * phrases and binary packs (length is limited to 0xFFFF then)
+ * @param msg_id message ID
+ * @param msg_index the index of the msg_id
+ * @param info filled with metadata of returned string
+ * @return the translation of `msg_id` on the set local
+ */
+const char * lv_i18n_get_singular_info_by_idx(const char * msg_id, int msg_index, lv_i18n_str_info_t * info);
+
+/**
+ * Same as `lv_i18n_get_plural_by_idx()`, and get metadata of result
+ */
+const char * lv_i18n_get_plural_info_by_idx(const char * msg_id, int msg_index, int32_t num,
+                                            lv_i18n_str_info_t * info);
+
+/**
+ * Same as `lv_i18n_get_singular_info_by_idx()`, for given context
+ */
+const char * lv_i18n_ctx_get_singular_info_by_idx(const lv_i18n_ctx_t * ctx, const char * msg_id, int msg_index,
+                                                  lv_i18n_str_info_t * info);
+
+/**
+ * Same as `lv_i18n_get_plural_info_by_idx()`, for given context
+ */
+const char * lv_i18n_ctx_get_plural_info_by_idx(const lv_i18n_ctx_t * ctx, const char * msg_id, int msg_index,
+                                                int32_t num, lv_i18n_str_info_t * info);
+
+#define lv_i18n_get_singular_info(text, info) lv_i18n_get_singular_info_by_idx(text, LV_I18N_ID_s(text), info)
+#define lv_i18n_get_plural_info(text, num, info) \
+    lv_i18n_get_plural_info_by_idx(text, LV_I18N_ID_p(text), num, info)
+#define lv_i18n_ctx_get_singular_info(ctx, text, info) \
+    lv_i18n_ctx_get_singular_info_by_idx(ctx, text, LV_I18N_ID_s(text), info)
+#define lv_i18n_ctx_get_plural_info(ctx, text, num, info) \
+    lv_i18n_ctx_get_plural_info_by_idx(ctx, text, LV_I18N_ID_p(text), num, info)
+#endif
 
 /**
  * Set the languages for internationalization
@@ -86,17 +438,185 @@ int lv_i18n_init(const lv_i18n_language_pack_t * langs);
 int lv_i18n_init_default(void);
 
 /**
- * Change the localization (language)
+ * Change the localization (language). Name is matched ignoring case and
+ * `_` / `-` difference. If no exact match, locale with the same language
+ * is used ("ru" => "ru-RU", "de-AT" => "de-DE").
  * @param l_name name of the translation locale to use. E.g. "en-GB"
  */
 int lv_i18n_set_locale(const char * l_name);
 
+/**
+ * Change the localization (language) by compiled locale ID, without search
+ * @param locale locale ID, `LV_I18N_LOCALE_EN_GB`
+ */
+int lv_i18n_set_locale_by_idx(lv_i18n_locale_t locale);
+
+/**
+ * Select the best available locale for priority list, in `Accept-Language`
+ * format. From locales with equal `q` the first one wins.
+ * @param accept_list list of locales, "de-CH, de;q=0.9, en;q=0.5, *;q=0.1"
+ * @return 0 on success, -1 if nothing matched (locale is not changed)
+ */
+int lv_i18n_set_locale_best_match(const char * accept_list);
+
+#ifdef LV_I18N_BINARY
+/**
+ * Load binary translations pack (created with `--binary` option), and switch
+ * to its first locale. Pack is used in place, without copying, so memory
+ * must stay valid while pack is used (flash, mmap-ed file, static buffer).
+ * `lv_i18n_init()` switches back to compiled translations.
+ * @param data pointer to pack
+ * @param size size of data
+ * @return 0 on success, -1 if pack is damaged or does not match phrase IDs of firmware
+ */
+int lv_i18n_load_pack_from_memory(const void * data, size_t size);
+
+/**
+ * Same as `lv_i18n_load_pack_from_memory()`, for given context
+ */
+int lv_i18n_ctx_load_pack_from_memory(lv_i18n_ctx_t * ctx, const void * data, size_t size);
+#endif
+
+#ifdef LV_I18N_SPLIT
+/**
+ * Add locale from separate file (`--split` mode) to compiled language pack.
+ * Base locale must be registered first. Not thread-safe, like `lv_i18n_init()`.
+ * @param lang locale, `&lv_i18n_lang_de_de`
+ * @return 0 on success, -1 if locale is unknown or compiled for other phrase IDs
+ */
+int lv_i18n_register_lang(const lv_i18n_lang_t * lang);
+#endif
+
 /**
  * Get the name of the currently used locale.
  * @return name of the currently used locale. E.g. "en-GB"
  */
 const char * lv_i18n_get_current_locale(void);
 
+/**
+ * Set the languages of context. Must not be called while context is used
+ * by other threads.
+ * @param ctx context to initialize
+ * @param langs pointer to the array of languages. (Last element has to be `NULL`)
+ */
+int lv_i18n_ctx_init(lv_i18n_ctx_t * ctx, const lv_i18n_language_pack_t * langs);
+
+/**
+ * Change the localization (language) of context. Can be called while
+ * other threads get translations from this context.
+ * @param ctx context
+ * @param l_name name of the translation locale to use. E.g. "en-GB"
+ */
+int lv_i18n_ctx_set_locale(lv_i18n_ctx_t * ctx, const char * l_name);
+
+/**
+ * Same as `lv_i18n_set_locale_by_idx()`, for given context
+ */
+int lv_i18n_ctx_set_locale_by_idx(lv_i18n_ctx_t * ctx, lv_i18n_locale_t locale);
+
+/**
+ * Same as `lv_i18n_set_locale_best_match()`, for given context
+ */
+int lv_i18n_ctx_set_locale_best_match(lv_i18n_ctx_t * ctx, const char * accept_list);
+
+/**
+ * Get the name of the locale, currently used in context.
+ * @param ctx context
+ * @return name of the currently used locale. E.g. "en-GB"
+ */
+const char * lv_i18n_ctx_get_current_locale(const lv_i18n_ctx_t * ctx);
+
+// Locale switch, passed to locale change callbacks
+typedef struct {
+    const lv_i18n_ctx_t * ctx;
+    const char * old_locale;
+    const char * new_locale;
+    const uint8_t * diff;   // bit per changed phrase: singulars, then plurals (NULL if none)
+    uint8_t all;            // diff is not known (no `--locale-diff`, custom or binary packs)
+} lv_i18n_locale_change_t;
+
+typedef void (*lv_i18n_locale_change_cb_t)(const lv_i18n_locale_change_t * change, void * user_data);
+
+/**
+ * Subscribe to locale switches of all contexts, to refresh texts on screen.
+ * Called from the thread, changing locale, after switch. Not thread-safe,
+ * subscribe before locale is changed from other threads.
+ * @param cb callback
+ * @param user_data passed to callback as is
+ * @return 0 on success, -1 if all `LV_I18N_LOCALE_CHANGE_CB_MAX` slots are used
+ */
+int lv_i18n_add_locale_change_cb(lv_i18n_locale_change_cb_t cb, void * user_data);
+
+/**
+ * Unsubscribe callback, added with the same `user_data`
+ * @return 0 on success, -1 if not found
+ */
+int lv_i18n_remove_locale_change_cb(lv_i18n_locale_change_cb_t cb, void * user_data);
+
+/**
+ * Check if text of singular phrase can differ after locale switch
+ * @param change locale switch, passed to callback
+ * @param msg_index the index of the msg_id
+ * @return 1 if text can be changed, 0 if it is the same
+ */
+int lv_i18n_is_singular_changed_by_idx(const lv_i18n_locale_change_t * change, int msg_index);
+
+/**
+ * Same as `lv_i18n_is_singular_changed_by_idx()`, for plural phrase (any form)
+ */
+int lv_i18n_is_plural_changed_by_idx(const lv_i18n_locale_change_t * change, int msg_index);
+
+#define lv_i18n_is_singular_changed(change, text) lv_i18n_is_singular_changed_by_idx(change, LV_I18N_ID_s(text))
+#define lv_i18n_is_plural_changed(change, text) lv_i18n_is_plural_changed_by_idx(change, LV_I18N_ID_p(text))
+
+#ifdef LV_I18N_STATS
+// Lookup counters (`LV_I18N_STATS` build mode). Not atomic, can be
+// slightly off when lookups run in parallel threads.
+typedef struct {
+    uint32_t hits;      // found in current locale
+    uint32_t fallbacks; // found in base locale
+    uint32_t misses;    // not translated, `msg_id` returned
+    uint32_t time;      // total lookup time, in `LV_I18N_STATS_TIME()` units
+} lv_i18n_stats_counter_t;
+
+typedef struct {
+    lv_i18n_stats_counter_t locales[LV_I18N_LOCALE_COUNT + 1]; // in language pack order + custom & binary packs
+    lv_i18n_stats_counter_t singulars[LV_I18N_SINGULAR_COUNT > 0 ? LV_I18N_SINGULAR_COUNT : 1];
+    lv_i18n_stats_counter_t plurals[LV_I18N_PLURAL_COUNT > 0 ? LV_I18N_PLURAL_COUNT : 1];
+    uint32_t not_found; // lookups of phrases, unknown at compile time
+} lv_i18n_stats_t;
+
+typedef enum {
+    LV_I18N_MISS_FALLBACK,      // taken from base locale
+    LV_I18N_MISS_UNTRANSLATED,  // not translated in current & base locale
+    LV_I18N_MISS_UNKNOWN        // phrase is unknown at compile time
+} lv_i18n_miss_t;
+
+typedef void (*lv_i18n_miss_cb_t)(const char * locale, const char * msg_id, int plural, lv_i18n_miss_t reason);
+
+/**
+ * Get lookup statistics, collected since start or last reset
+ */
+const lv_i18n_stats_t * lv_i18n_stats_get(void);
+
+/**
+ * Reset lookup statistics
+ */
+void lv_i18n_stats_reset(void);
+
+/**
+ * Set function, called for each lookup without translation in current
+ * locale (NULL to disable). Called from the thread, doing lookup.
+ * @param cb callback
+ */
+void lv_i18n_set_miss_callback(lv_i18n_miss_cb_t cb);
+
+/**
+ * Print statistics line by line: locales, then phrases with non-zero counters
+ * @param print function to output line (without "\n")
+ */
+void lv_i18n_stats_dump(void (*print)(const char * line));
+#endif
 
 void __lv_i18n_reset(void);
 
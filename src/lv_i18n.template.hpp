@@ -0,0 +1,164 @@
+#ifndef LV_I18N_HPP
+#define LV_I18N_HPP
+
+// C++ front end (see `--cpp` option). Phrase IDs are resolved at compile time
+// in any build mode, so lookup is a direct table access, without hashing or
+// string compare. Unknown phrases and plural / singular mismatch fail to
+// compile. Uses the same `lv_i18n.c`.
+//
+// C++17:
+//
+//   LV_I18N_TR("title")
+//   LV_I18N_TRP("items", count)
+//
+// C++20:
+//
+//   lv_i18n::tr<"title">()
+//   lv_i18n::trp<"items">(count)
+//   lv_i18n::tr<"title">(&ctx)
+//
+//   using namespace lv_i18n::literals;
+//   "title"_tr
+
+#include "lv_i18n.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lv_i18n {
+namespace detail {
+
+/*SAMPLE_START*/
+// Phrases in ID order, NULL-terminated
+inline constexpr const char * singular_keys[] = {
+    "s_dogs_of",
+    "s_en_only",
+    "s_translated",
+    "s_untranslated",
+    nullptr
+};
+
+inline constexpr const char * plural_keys[] = {
+    "p_i_have_dogs",
+    nullptr
+};
+/*SAMPLE_END*/
+
+static_assert(sizeof(singular_keys) / sizeof(singular_keys[0]) == LV_I18N_SINGULAR_COUNT + 1 &&
+              sizeof(plural_keys) / sizeof(plural_keys[0]) == LV_I18N_PLURAL_COUNT + 1,
+              "lv_i18n: lv_i18n.hpp does not match lv_i18n.h, compile both with the same translations");
+
+constexpr bool str_eq(const char * a, const char * b)
+{
+    while(*a != '\0' && *a == *b) {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+// Phrase ID, -1 if not found
+constexpr int find(const char * const * keys, const char * key)
+{
+    for(int i = 0; keys[i] != nullptr; i++) {
+        if(str_eq(keys[i], key)) return i;
+    }
+    return -1;
+}
+
+constexpr int singular_id(const char * key)
+{
+    return find(singular_keys, key);
+}
+
+constexpr int plural_id(const char * key)
+{
+    return find(plural_keys, key);
+}
+
+// Phrase ID as compile-time constant, with usage checks
+template <int Id, int OtherId>
+struct singular {
+    static_assert(Id >= 0 || OtherId < 0, "lv_i18n: plural phrase is used as singular, use trp()");
+    static_assert(Id >= 0 || OtherId >= 0, "lv_i18n: unknown phrase");
+    static constexpr int value = Id;
+};
+
+template <int Id, int OtherId>
+struct plural {
+    static_assert(Id >= 0 || OtherId < 0, "lv_i18n: singular phrase is used as plural, use tr()");
+    static_assert(Id >= 0 || OtherId >= 0, "lv_i18n: unknown phrase");
+    static constexpr int value = Id;
+};
+
+#if __cplusplus >= 202002L
+// String literal as template argument
+template <std::size_t N>
+struct key_string {
+    char str[N];
+
+    constexpr key_string(const char (&s)[N])
+    {
+        for(std::size_t i = 0; i < N; i++) str[i] = s[i];
+    }
+};
+#endif
+
+} // namespace detail
+
+#if __cplusplus >= 202002L
+
+template <detail::key_string Key>
+inline const char * tr()
+{
+    constexpr int id = detail::singular<detail::singular_id(Key.str), detail::plural_id(Key.str)>::value;
+
+    return lv_i18n_get_singular_by_idx(Key.str, id);
+}
+
+template <detail::key_string Key>
+inline const char * tr(const lv_i18n_ctx_t * ctx)
+{
+    constexpr int id = detail::singular<detail::singular_id(Key.str), detail::plural_id(Key.str)>::value;
+
+    return lv_i18n_ctx_get_singular_by_idx(ctx, Key.str, id);
+}
+
+template <detail::key_string Key>
+inline const char * trp(int32_t num)
+{
+    constexpr int id = detail::plural<detail::plural_id(Key.str), detail::singular_id(Key.str)>::value;
+
+    return lv_i18n_get_plural_by_idx(Key.str, id, num);
+}
+
+template <detail::key_string Key>
+inline const char * trp(const lv_i18n_ctx_t * ctx, int32_t num)
+{
+    constexpr int id = detail::plural<detail::plural_id(Key.str), detail::singular_id(Key.str)>::value;
+
+    return lv_i18n_ctx_get_plural_by_idx(ctx, Key.str, id, num);
+}
+
+namespace literals {
+
+template <detail::key_string Key>
+inline const char * operator""_tr()
+{
+    return tr<Key>();
+}
+
+} // namespace literals
+
+#endif
+
+} // namespace lv_i18n
+
+#define LV_I18N_TR(key) \
+    lv_i18n_get_singular_by_idx(key, ::lv_i18n::detail::singular<::lv_i18n::detail::singular_id(key), \
+                                ::lv_i18n::detail::plural_id(key)>::value)
+#define LV_I18N_TRP(key, num) \
+    lv_i18n_get_plural_by_idx(key, ::lv_i18n::detail::plural<::lv_i18n::detail::plural_id(key), \
+                              ::lv_i18n::detail::singular_id(key)>::value, num)
+
+#endif /*LV_I18N_HPP*/
@@ -0,0 +1,110 @@
+#!/usr/bin/env node
+
+// Measure C compile time & object size of generated code for big
+// amount of keys, with and without `--optimize`.
+//
+// Usage: [CC=gcc] [CFLAGS=-O2] ./support/bench_compile.js [keys...]
+//
+'use strict';
+
+/* eslint-disable no-console */
+
+const shell = require('shelljs');
+const { execFileSync } = require('child_process');
+const { mkdtempSync, writeFileSync, statSync } = require('fs');
+const { join } = require('path');
+const { tmpdir } = require('os');
+const { run } = require('../lib/cli');
+
+
+const CC = process.env.CC || 'cc';
+const CFLAGS = (process.env.CFLAGS || '-O2').split(/\s+/).filter(Boolean);
+const CALL_SITES = 500;
+
+const sizes = process.argv.slice(2).map(Number).filter(Boolean);
+if (!sizes.length) sizes.push(1000, 5000, 10000);
+
+
+function create_yaml(keys_count) {
+  let en = 'en-GB:\n';
+  let ru = 'ru-RU:\n';
+
+  for (let i = 0; i < keys_count; i++) {
+    en += `  screen_${i % 97}.label_${i}: Label number ${i}\n`;
+    // Leave 30% untranslated, to have fallbacks
+    ru += `  screen_${i % 97}.label_${i}: ${i % 10 < 3 ? '~' : `Надпись номер ${i}`}\n`;
+  }
+
+  for (let i = 0; i < keys_count / 10; i++) {
+    en += `  items_${i}:\n    one: '%d item ${i}'\n    other: '%d items ${i}'\n`;
+  }
+
+  return en + '\n' + ru;
+}
+
+
+function create_source(keys_count) {
+  let src = '#include "lv_i18n.h"\n\nconst char * results[' + (CALL_SITES * 2) + '];\n\nvoid use(int32_t n)\n{\n';
+
+  for (let i = 0; i < CALL_SITES; i++) {
+    const k = (i * 7919) % keys_count;
+    src += `    results[${i * 2}] = _("screen_${k % 97}.label_${k}");\n`;
+    src += `    results[${i * 2 + 1}] = _p("items_${k % Math.ceil(keys_count / 10)}", n);\n`;
+  }
+
+  return src + '}\n';
+}
+
+
+function compile(dir, file) {
+  const obj = join(dir, file.replace(/\.c$/, '.o'));
+  const start = process.hrtime.bigint();
+
+  execFileSync(CC, [ ...CFLAGS, '-c', '-I', dir, join(dir, file), '-o', obj ]);
+
+  const time = Number(process.hrtime.bigint() - start) / 1e6;
+  let size;
+
+  try {
+    // text + data + bss
+    size = Number(execFileSync('size', [ obj ]).toString().split('\n')[1].trim().split(/\s+/)[3]);
+  } catch (__) {
+    size = statSync(obj).size;
+  }
+
+  return { time, size };
+}
+
+
+const results = [];
+
+sizes.forEach(keys_count => {
+  [ false, true ].forEach(optimize => {
+    const dir = mkdtempSync(join(tmpdir(), 'lv_i18n_bench_'));
+
+    try {
+      writeFileSync(join(dir, 'translations.yml'), create_yaml(keys_count));
+      writeFileSync(join(dir, 'calls.c'), create_source(keys_count));
+
+      run([ 'compile', '-t', join(dir, 'translations.yml'), '-o', dir, '-l', 'en-GB' ]
+        .concat(optimize ? [ '--optimize' ] : []));
+
+      const lib = compile(dir, 'lv_i18n.c');
+      const calls = compile(dir, 'calls.c');
+
+      results.push({
+        keys: keys_count,
+        mode: optimize ? 'optimize' : 'runtime',
+        'lv_i18n.c, ms': lib.time.toFixed(0),
+        'lv_i18n.o, bytes': lib.size,
+        [`calls.c (${CALL_SITES * 2} calls), ms`]: calls.time.toFixed(0),
+        'calls.o, bytes': calls.size
+      });
+    } finally {
+      shell.rm('-rf', dir);
+    }
+  });
+});
+
+console.log(`${CC} ${CFLAGS.join(' ')}`);
+console.table(results);
@@ -0,0 +1,119 @@
+#!/usr/bin/env node
+
+// Compare formatted translations: `snprintf()` over `_()` / `_p()` result
+// (current way), `lv_i18n_format()` with runtime parsing and with
+// pre-parsed format strings (`--format-tokens`).
+//
+// Usage: [CC=gcc] [CFLAGS=-O2] ./support/bench_format.js
+//
+'use strict';
+
+/* eslint-disable no-console */
+
+const shell = require('shelljs');
+const { execFileSync } = require('child_process');
+const { mkdtempSync, writeFileSync } = require('fs');
+const { join } = require('path');
+const { tmpdir } = require('os');
+const { run } = require('../lib/cli');
+
+
+const CC = process.env.CC || 'cc';
+const CFLAGS = (process.env.CFLAGS || '-O2').split(/\s+/).filter(Boolean);
+const CALLS = 5000000;
+
+const YAML = `
+en-GB:
+  status: '%s: %d of %d done'
+  items:
+    one: '%d item'
+    other: '%d items'
+
+de-DE:
+  status: '%3$d von %2$d erledigt (%1$s)'
+  items:
+    one: '%d Element'
+    other: '%d Elemente'
+`;
+
+// Expressions to measure for each API, `i` is loop counter
+const CASES = [
+  {
+    name: 'singular, 3 args',
+    snprintf: 'snprintf(buf, sizeof(buf), _("status"), "Copy", i, 1000)',
+    format: 'lv_i18n_format(buf, sizeof(buf), "status", "Copy", i, 1000)'
+  },
+  {
+    name: 'plural, 1 arg',
+    snprintf: 'snprintf(buf, sizeof(buf), _p("items", i), i)',
+    format: 'lv_i18n_format_plural(buf, sizeof(buf), "items", i, i)'
+  }
+];
+
+
+function create_source(api) {
+  return `
+#include <stdio.h>
+#include <time.h>
+#include "lv_i18n.h"
+
+static char buf[64];
+static volatile int sink;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(void)
+{
+    int32_t i;
+    double start;
+
+    lv_i18n_init(lv_i18n_language_pack);
+    lv_i18n_set_locale("de-DE");
+${CASES.map(c => `
+    start = now();
+    for(i = 0; i < ${CALLS}; i++) sink += ${c[api]};
+    printf("%.2f\\n", (now() - start) / ${CALLS});
+`).join('')}
+    return 0;
+}
+`;
+}
+
+
+const MODES = [
+  { name: 'snprintf(_())', api: 'snprintf', args: [] },
+  { name: 'lv_i18n_format()', api: 'format', args: [] },
+  { name: 'lv_i18n_format() --format-tokens', api: 'format', args: [ '--format-tokens' ] }
+];
+
+const results = [];
+
+MODES.forEach(mode => {
+  const dir = mkdtempSync(join(tmpdir(), 'lv_i18n_bench_'));
+
+  try {
+    writeFileSync(join(dir, 'translations.yml'), YAML);
+    writeFileSync(join(dir, 'main.c'), create_source(mode.api));
+
+    run([ 'compile', '-t', join(dir, 'translations.yml'), '-o', dir, '-l', 'en-GB', '--optimize' ].concat(mode.args));
+
+    execFileSync(CC, [ ...CFLAGS, '-I', dir, join(dir, 'main.c'), join(dir, 'lv_i18n.c'), '-o', join(dir, 'bench') ]);
+
+    const times = execFileSync(join(dir, 'bench')).toString().trim().split('\n');
+    const row = { mode: mode.name };
+
+    CASES.forEach((c, i) => { row[`${c.name}, ns/call`] = times[i]; });
+
+    results.push(row);
+  } finally {
+    shell.rm('-rf', dir);
+  }
+});
+
+console.log(`${CC} ${CFLAGS.join(' ')}`);
+console.table(results);
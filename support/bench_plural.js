@@ -0,0 +1,113 @@
+#!/usr/bin/env node
+
+// Compare plural forms selection via generated C functions (default) and
+// via shared table interpreter (`--plural-table`): per-call latency of
+// `_p()` and object size.
+//
+// Usage: [CC=gcc] [CFLAGS=-O2] ./support/bench_plural.js
+//
+'use strict';
+
+/* eslint-disable no-console */
+
+const shell = require('shelljs');
+const { execFileSync } = require('child_process');
+const { mkdtempSync, writeFileSync } = require('fs');
+const { join } = require('path');
+const { tmpdir } = require('os');
+const { run } = require('../lib/cli');
+const { getPluralKeys } = require('../lib/plurals');
+
+
+const CC = process.env.CC || 'cc';
+const CFLAGS = (process.env.CFLAGS || '-O2').split(/\s+/).filter(Boolean);
+const LOCALES = [ 'en-GB', 'de-DE', 'fr-FR', 'ru-RU', 'uk-UA', 'pl-PL', 'ar-EG', 'ja-JP' ];
+const RANGES = [ [ 0, 200 ], [ 1000, 1000000 ] ];
+const CALLS = 10000000;
+
+
+function create_yaml() {
+  return LOCALES.map(l => `${l}:\n  items:\n` +
+    getPluralKeys(l).map(form => `    ${form}: '%d items (${form})'\n`).join('')).join('\n');
+}
+
+
+function create_source() {
+  return `
+#include <stdio.h>
+#include <time.h>
+#include "lv_i18n.h"
+
+static const char * volatile sink;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(void)
+{
+    static const char * locales[] = { ${LOCALES.map(l => `"${l}"`).join(', ')} };
+    static const int32_t ranges[][2] = { ${RANGES.map(r => `{ ${r[0]}, ${r[1]} }`).join(', ')} };
+    unsigned r, l;
+    int32_t i, n;
+    double start;
+
+    lv_i18n_init(lv_i18n_language_pack);
+
+    for(r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++) {
+        start = now();
+
+        for(l = 0; l < sizeof(locales) / sizeof(locales[0]); l++) {
+            lv_i18n_set_locale(locales[l]);
+
+            for(i = 0, n = ranges[r][0]; i < ${Math.floor(CALLS / LOCALES.length)}; i++) {
+                sink = _p("items", n);
+                if(++n >= ranges[r][1]) n = ranges[r][0];
+            }
+        }
+
+        printf("%.2f\\n", (now() - start) / ${Math.floor(CALLS / LOCALES.length) * LOCALES.length});
+    }
+
+    return 0;
+}
+`;
+}
+
+
+function text_size(obj) {
+  return Number(execFileSync('size', [ obj ]).toString().split('\n')[1].trim().split(/\s+/)[0]);
+}
+
+
+const results = [];
+
+[ false, true ].forEach(table => {
+  const dir = mkdtempSync(join(tmpdir(), 'lv_i18n_bench_'));
+
+  try {
+    writeFileSync(join(dir, 'translations.yml'), create_yaml());
+    writeFileSync(join(dir, 'main.c'), create_source());
+
+    run([ 'compile', '-t', join(dir, 'translations.yml'), '-o', dir, '-l', 'en-GB', '--optimize' ]
+      .concat(table ? [ '--plural-table' ] : []));
+
+    execFileSync(CC, [ ...CFLAGS, '-c', join(dir, 'lv_i18n.c'), '-o', join(dir, 'lv_i18n.o') ]);
+    execFileSync(CC, [ ...CFLAGS, '-I', dir, join(dir, 'main.c'), join(dir, 'lv_i18n.o'), '-o', join(dir, 'bench') ]);
+
+    const times = execFileSync(join(dir, 'bench')).toString().trim().split('\n');
+    const row = { mode: table ? '--plural-table' : 'functions', 'lv_i18n.o text, bytes': text_size(join(dir, 'lv_i18n.o')) };
+
+    RANGES.forEach((r, i) => { row[`n in [${r[0]}, ${r[1]}), ns/call`] = times[i]; });
+
+    results.push(row);
+  } finally {
+    shell.rm('-rf', dir);
+  }
+});
+
+console.log(`${CC} ${CFLAGS.join(' ')}, ${LOCALES.length} locales`);
+console.table(results);
@@ -0,0 +1,255 @@
+#!/usr/bin/env node
+
+// Measure runtime of lookups (`_()`, `_i()`, `_p()`), locale switch and ID
+// resolvers, plus code/data size, on synthetic translations. Every set is
+// built in each of `MODES` and run by `test/c/bench.c`.
+//
+// Usage: [CC=gcc] [CFLAGS=-O2] ./support/bench_runtime.js [options]
+//
+//   --keys 1000,5000      singular keys count (plurals are 1/10 of it)
+//   --locales 2,10        locales count, including base one
+//   --fallback 0,0.3      share of untranslated phrases in non-base locales
+//   --output file.json    write results as JSON, instead of stdout
+//
+// Lists make a full matrix. Default is a fixed set of typical cases.
+//
+'use strict';
+
+/* eslint-disable no-console */
+
+const shell = require('shelljs');
+const { execFileSync } = require('child_process');
+const { mkdtempSync, writeFileSync } = require('fs');
+const { join } = require('path');
+const { tmpdir } = require('os');
+const { ArgumentParser } = require('argparse');
+const { run } = require('../lib/cli');
+const { getPluralKeys } = require('../lib/plurals');
+
+
+const CC = process.env.CC || 'cc';
+const CFLAGS = (process.env.CFLAGS || '-O2').split(/\s+/).filter(Boolean);
+const CALL_SITES = 256;
+const HARNESS = join(__dirname, '..', 'test', 'c', 'bench.c');
+
+// Compile options of compared modes
+const MODES = {
+  runtime: [],
+  optimize: [ '--optimize' ],
+  // Decode cost on lookup, vs. `optimize`
+  compress: [ '--optimize', '--compress' ]
+};
+
+// Languages for non-base locales, with different plural rules
+const LANGUAGES = [
+  'de', 'fr', 'ru', 'uk', 'pl', 'ar', 'ja', 'zh', 'es', 'it', 'pt', 'nl', 'sv', 'cs', 'tr',
+  'ko', 'he', 'fi', 'da', 'nb', 'hu', 'ro', 'el', 'bg', 'hr', 'sk', 'sl', 'lt', 'lv'
+];
+
+const PRESETS = [
+  { keys: 1000, locales: 2, fallback: 0.3 },
+  { keys: 5000, locales: 10, fallback: 0 },
+  { keys: 5000, locales: 10, fallback: 0.3 },
+  { keys: 5000, locales: 10, fallback: 0.9 },
+  { keys: 20000, locales: 30, fallback: 0.3 }
+];
+
+
+function list(type) {
+  return str => str.split(',').map(type);
+}
+
+const parser = new ArgumentParser({ description: 'lv_i18n runtime benchmark' });
+
+parser.add_argument('--keys', { type: list(Number) });
+parser.add_argument('--locales', { type: list(Number) });
+parser.add_argument('--fallback', { type: list(Number) });
+parser.add_argument('-o', '--output');
+
+const args = parser.parse_args();
+
+
+function create_sets() {
+  if (!args.keys && !args.locales && !args.fallback) return PRESETS;
+
+  const sets = [];
+
+  (args.keys || [ 5000 ]).forEach(keys => {
+    (args.locales || [ 10 ]).forEach(locales => {
+      (args.fallback || [ 0.3 ]).forEach(fallback => sets.push({ keys, locales, fallback }));
+    });
+  });
+
+  return sets;
+}
+
+
+function locale_names(count) {
+  if (count > LANGUAGES.length + 1) throw new Error(`Max ${LANGUAGES.length + 1} locales supported`);
+
+  return [ 'en-GB' ].concat(LANGUAGES.slice(0, count - 1).map(l => `${l}-${l.toUpperCase()}`));
+}
+
+const singular_key = i => `screen_${i % 97}.label_${i}`;
+const plural_key = i => `items_${i}`;
+
+// Deterministic pseudo-random choice of untranslated phrases
+function untranslated(i, locale_idx, fallback) {
+  return ((i * 7919 + locale_idx * 104729) % 1000) < fallback * 1000;
+}
+
+
+function create_yaml(set) {
+  const plurals_count = Math.ceil(set.keys / 10);
+
+  return locale_names(set.locales).map((locale, l) => {
+    let out = `${locale}:\n`;
+
+    for (let i = 0; i < set.keys; i++) {
+      const skip = l > 0 && untranslated(i, l, set.fallback);
+      out += `  ${singular_key(i)}: ${skip ? '~' : `Label ${i} (${locale})`}\n`;
+    }
+
+    for (let i = 0; i < plurals_count; i++) {
+      if (l > 0 && untranslated(i, l, set.fallback)) continue;
+
+      out += `  ${plural_key(i)}:\n`;
+      getPluralKeys(locale).forEach(form => { out += `    ${form}: '%d items ${i} (${form})'\n`; });
+    }
+
+    return out;
+  }).join('\n');
+}
+
+
+function create_calls(set) {
+  const locales = locale_names(set.locales);
+  const plurals_count = Math.ceil(set.keys / 10);
+  const s_keys = [];
+  const p_keys = [];
+
+  // Spread call sites over all keys
+  for (let i = 0; i < CALL_SITES; i++) {
+    s_keys.push(singular_key((i * 7919) % set.keys));
+    p_keys.push(plural_key((i * 7919) % plurals_count));
+  }
+
+  return `#include "lv_i18n.h"
+
+const unsigned bench_calls = ${CALL_SITES};
+
+const char * const bench_locales[] = {
+${locales.map(l => `    "${l}",`).join('\n')}
+};
+
+const unsigned bench_locales_count = ${locales.length};
+
+const char * const bench_singular_keys[] = {
+${s_keys.map(k => `    "${k}",`).join('\n')}
+};
+
+const char * const bench_plural_keys[] = {
+${p_keys.map(k => `    "${k}",`).join('\n')}
+};
+
+void bench_singulars(const char ** out);
+void bench_singulars_cached(const char ** out);
+void bench_singulars_batch(const char ** out);
+void bench_plurals(const char ** out, int32_t num);
+
+void bench_singulars(const char ** out)
+{
+${s_keys.map((k, i) => `    out[${i}] = _("${k}");`).join('\n')}
+}
+
+void bench_singulars_cached(const char ** out)
+{
+${s_keys.map((k, i) => `    out[${i}] = _i("${k}");`).join('\n')}
+}
+
+#ifndef LV_I18N_COMPRESS
+// IDs are resolved once, as for lists of \`--screens\` option
+void bench_singulars_batch(const char ** out)
+{
+    static uint16_t ids[${CALL_SITES}];
+    static int ready;
+
+    if(!ready) {
+${s_keys.map((k, i) => `        ids[${i}] = (uint16_t)LV_I18N_ID_s("${k}");`).join('\n')}
+        ready = 1;
+    }
+
+    lv_i18n_get_singular_batch(ids, ${CALL_SITES}, out);
+}
+#endif
+
+void bench_plurals(const char ** out, int32_t num)
+{
+${p_keys.map((k, i) => `    out[${i}] = _p("${k}", num);`).join('\n')}
+}
+`;
+}
+
+
+// text / data / bss of object file, in Berkeley format
+function size(obj) {
+  const [ text, data, bss ] = execFileSync('size', [ obj ]).toString().split('\n')[1].trim().split(/\s+/).map(Number);
+
+  return { text, data, bss };
+}
+
+
+function bench(set, mode) {
+  const dir = mkdtempSync(join(tmpdir(), 'lv_i18n_bench_'));
+
+  try {
+    writeFileSync(join(dir, 'translations.yml'), create_yaml(set));
+    writeFileSync(join(dir, 'bench_calls.c'), create_calls(set));
+
+    run([ 'compile', '-t', join(dir, 'translations.yml'), '-o', dir, '-l', 'en-GB' ].concat(MODES[mode]));
+
+    const cc = (src, obj) => execFileSync(CC, [ ...CFLAGS, '-c', '-I', dir, src, '-o', join(dir, obj) ]);
+
+    cc(join(dir, 'lv_i18n.c'), 'lv_i18n.o');
+    cc(join(dir, 'bench_calls.c'), 'bench_calls.o');
+    cc(HARNESS, 'bench.o');
+
+    execFileSync(CC, [ ...CFLAGS, ...[ 'lv_i18n.o', 'bench_calls.o', 'bench.o' ].map(o => join(dir, o)),
+      '-o', join(dir, 'bench') ]);
+
+    return Object.assign({}, set, {
+      mode,
+      'ns/op': JSON.parse(execFileSync(join(dir, 'bench')).toString()),
+      size: { 'lv_i18n.o': size(join(dir, 'lv_i18n.o')), 'bench_calls.o': size(join(dir, 'bench_calls.o')) }
+    });
+  } finally {
+    shell.rm('-rf', dir);
+  }
+}
+
+
+const results = [];
+
+create_sets().forEach(set => {
+  Object.keys(MODES).forEach(mode => results.push(bench(set, mode)));
+});
+
+const report = {
+  version: require('../package.json').version,
+  cc: `${CC} ${CFLAGS.join(' ')}`,
+  calls: CALL_SITES,
+  results
+};
+
+if (args.output) {
+  writeFileSync(args.output, JSON.stringify(report, null, 2) + '\n');
+
+  console.log(report.cc);
+  console.table(results.map(r => Object.assign(
+    { keys: r.keys, locales: r.locales, fallback: r.fallback, mode: r.mode },
+    r['ns/op'],
+    { 'text, bytes': r.size['lv_i18n.o'].text, 'data, bytes': r.size['lv_i18n.o'].data }
+  )));
+} else {
+  console.log(JSON.stringify(report, null, 2));
+}
@@ -0,0 +1,107 @@
+#!/usr/bin/env node
+
+// Check that `compile` and `extract` time grows near-linearly with phrases
+// count. Translations are synthetic, for 25 locales. Exits with error, if
+// N times more phrases take 3N times longer or more (quadratic is N^2).
+//
+// Usage: ./support/bench_scaling.js [small_keys] [big_keys]
+//
+'use strict';
+
+/* eslint-disable no-console */
+
+const shell = require('shelljs');
+const { mkdtempSync, writeFileSync } = require('fs');
+const { join } = require('path');
+const { tmpdir } = require('os');
+const { run } = require('../lib/cli');
+
+
+const SMALL = Number(process.argv[2]) || 500;   // x 25 locales = 12.5k phrases
+const BIG = Number(process.argv[3]) || 4000;    // x 25 locales = 100k phrases
+const MAX_RATIO = 3 * BIG / SMALL;
+
+const LOCALES = [
+  'en-GB', 'de-DE', 'fr-FR', 'ru-RU', 'uk-UA', 'pl-PL', 'ar-EG', 'ja-JP', 'zh-CN', 'de-AT',
+  'fr-CA', 'ru-BY', 'en-US', 'de-CH', 'fr-BE', 'en-AU', 'pl-XX', 'uk-XX', 'ar-SA', 'ja-XX',
+  'zh-TW', 'en-CA', 'de-LU', 'fr-CH', 'en-NZ'
+];
+
+
+// Translations for `keys` x 25 locales, one file per locale. Sources use
+// every key twice.
+function create_data(dir, keys) {
+  shell.rm('-rf', join(dir, '*'));
+
+  LOCALES.forEach((locale, l) => {
+    let yml = `${locale}:\n`;
+
+    for (let i = 0; i < keys; i++) {
+      if (i % 10) yml += `  screen_${i % 97}.label_${i}: 'Label ${i} ${l}'\n`;
+      else yml += `  items_${i}:\n    other: '%d items ${i} ${l}'\n`;
+    }
+
+    writeFileSync(join(dir, `${locale}.yml`), yml);
+  });
+
+  let src = '';
+
+  for (let i = 0; i < keys; i++) {
+    src += i % 10 ? `a = _("screen_${i % 97}.label_${i}");\n` : `b = _p("items_${i}", n);\n`;
+  }
+
+  writeFileSync(join(dir, 'src.c'), src + src);
+}
+
+
+function measure(dir, keys, args) {
+  create_data(dir, keys);
+
+  const log = console.log;
+  const start = process.hrtime.bigint();
+
+  console.log = () => {};
+
+  try {
+    run(args);
+  } finally {
+    console.log = log;
+  }
+
+  return Number(process.hrtime.bigint() - start) / 1e6;
+}
+
+
+const COMMANDS = {
+  compile: dir => [ 'compile', '-t', join(dir, '*.yml'), '--raw', join(dir, 'out.c'), '-l', 'en-GB' ],
+  extract: dir => [ 'extract', '-s', join(dir, 'src.c'), '-t', join(dir, '*.yml'),
+    '--dump-sourceref', join(dir, 'sourceref.json') ]
+};
+
+const dir = mkdtempSync(join(tmpdir(), 'lv_i18n_bench_'));
+const results = [];
+
+try {
+  Object.entries(COMMANDS).forEach(([ name, args ]) => {
+    measure(dir, SMALL, args(dir)); // warm up
+
+    const small = measure(dir, SMALL, args(dir));
+    const big = measure(dir, BIG, args(dir));
+
+    results.push({
+      command: name,
+      [`${SMALL * LOCALES.length} phrases, ms`]: small.toFixed(0),
+      [`${BIG * LOCALES.length} phrases, ms`]: big.toFixed(0),
+      ratio: (big / small).toFixed(1)
+    });
+
+    if (big / small >= MAX_RATIO) {
+      console.error(`${name}: ${BIG / SMALL}x phrases took ${(big / small).toFixed(1)}x time`);
+      process.exitCode = 1;
+    }
+  });
+} finally {
+  shell.rm('-rf', dir);
+}
+
+console.table(results);
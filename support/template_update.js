@@ -11,11 +11,13 @@ const { run } = require('../lib/cli');
 
 const tmp_file = join(__dirname, 'raw.tmp');
 const tmp_file_h = join(dirname(tmp_file), basename(tmp_file, extname(tmp_file)) + '.h');
+const tmp_file_hpp = join(dirname(tmp_file), basename(tmp_file, extname(tmp_file)) + '.hpp');
 const template_c = join(__dirname, '../src/lv_i18n.template.c');
 const template_h = join(__dirname, '../src/lv_i18n.template.h');
+const template_hpp = join(__dirname, '../src/lv_i18n.template.hpp');
 const template_yaml = join(__dirname, 'template_data.yml');
 
-run([ 'compile', '-t', template_yaml, '--raw', tmp_file ]);
+run([ 'compile', '-t', template_yaml, '--raw', tmp_file, '--cpp' ]);
 
 let txt_raw = fs.readFileSync(tmp_file, 'utf-8');
 let txt = fs.readFileSync(template_c, 'utf-8');
@@ -38,4 +40,13 @@ ${txt_raw}
 
 fs.writeFileSync(template_h, txt);
 
-shell.rm('-rf', tmp_file, tmp_file_h);
+txt_raw = fs.readFileSync(tmp_file_hpp, 'utf-8');
+txt = fs.readFileSync(template_hpp, 'utf-8');
+
+txt = txt.replace(/\/\*SAMPLE_START\*\/([\s\S]+)\/\*SAMPLE_END\*\//,
+  `/*SAMPLE_START*/
+${txt_raw}/*SAMPLE_END*/`);
+
+fs.writeFileSync(template_hpp, txt);
+
+shell.rm('-rf', tmp_file, tmp_file_h, tmp_file_hpp);
@@ -0,0 +1,158 @@
+/*
+ * Runtime benchmark of lookup, plural and locale switch paths.
+ *
+ * Linked with generated `lv_i18n.c` and `bench_calls.c` (see
+ * `support/bench_runtime.js`), prints results as JSON object to stdout.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <time.h>
+#include "lv_i18n.h"
+
+/* Minimal duration of one measurement, ns */
+#ifndef BENCH_MIN_TIME
+#define BENCH_MIN_TIME 50000000.0
+#endif
+
+/* Provided by generated bench_calls.c */
+extern const char * const bench_locales[];
+extern const unsigned bench_locales_count;
+extern const char * const bench_singular_keys[];
+extern const char * const bench_plural_keys[];
+extern const unsigned bench_calls;
+void bench_singulars(const char ** out);
+void bench_singulars_cached(const char ** out);
+void bench_singulars_batch(const char ** out);
+void bench_plurals(const char ** out, int32_t num);
+
+static const char * results[1024];
+static volatile unsigned sink;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Each case does `bench_calls` operations per run */
+typedef void (*bench_fn_t)(unsigned run);
+
+static void run_singular(unsigned run)
+{
+    (void)run;
+    bench_singulars(results);
+    sink += (unsigned char)results[0][0];
+}
+
+/* Same call sites via `_i()`, steady state: locale is not changed */
+static void run_singular_cached(unsigned run)
+{
+    (void)run;
+    bench_singulars_cached(results);
+    sink += (unsigned char)results[0][0];
+}
+
+#ifndef LV_I18N_COMPRESS
+/* Same phrases with IDs resolved once, by one batch call */
+static void run_singular_batch(unsigned run)
+{
+    (void)run;
+    bench_singulars_batch(results);
+    sink += (unsigned char)results[0][0];
+}
+#endif
+
+static void run_plural(unsigned run)
+{
+    bench_plurals(results, (int32_t)(run % 128));
+    sink += (unsigned char)results[0][0];
+}
+
+static void run_set_locale(unsigned run)
+{
+    unsigned i;
+    for(i = 0; i < bench_calls; i++) {
+        sink += (unsigned)lv_i18n_set_locale(bench_locales[(run + i) % bench_locales_count]);
+    }
+}
+
+static void run_set_locale_by_idx(unsigned run)
+{
+    unsigned i;
+    for(i = 0; i < bench_calls; i++) {
+        sink += (unsigned)lv_i18n_set_locale_by_idx((lv_i18n_locale_t)((run + i) % bench_locales_count));
+    }
+}
+
+#ifndef LV_I18N_OPTIMIZE
+static void run_singular_id(unsigned run)
+{
+    unsigned i;
+    (void)run;
+    for(i = 0; i < bench_calls; i++) sink += (unsigned)lv_i18n_get_singular_id(bench_singular_keys[i]);
+}
+
+static void run_plural_id(unsigned run)
+{
+    unsigned i;
+    (void)run;
+    for(i = 0; i < bench_calls; i++) sink += (unsigned)lv_i18n_get_plural_id(bench_plural_keys[i]);
+}
+#endif
+
+/* Repeat runs until BENCH_MIN_TIME passed, return ns per operation */
+static double measure(bench_fn_t fn)
+{
+    unsigned runs = 1;
+
+    fn(0); /* warm up */
+
+    for(;;) {
+        unsigned i;
+        double start = now();
+        double time;
+
+        for(i = 0; i < runs; i++) fn(i);
+
+        time = now() - start;
+        if(time >= BENCH_MIN_TIME) return time / runs / bench_calls;
+        runs *= 2;
+    }
+}
+
+int main(void)
+{
+    /* Lookups are measured in the last locale, to include fallbacks */
+    lv_i18n_locale_t locale = (lv_i18n_locale_t)(bench_locales_count - 1);
+
+    lv_i18n_init(lv_i18n_language_pack);
+
+    lv_i18n_set_locale_by_idx(locale);
+    printf("{\n  \"singular\": %.2f,\n", measure(run_singular));
+    printf("  \"singular_cached\": %.2f,\n", measure(run_singular_cached));
+#ifndef LV_I18N_COMPRESS
+    printf("  \"singular_batch\": %.2f,\n", measure(run_singular_batch));
+#else
+    /* Decoded strings are recycled, no batch lookup */
+    printf("  \"singular_batch\": null,\n");
+#endif
+
+    lv_i18n_set_locale_by_idx(locale);
+    printf("  \"plural\": %.2f,\n", measure(run_plural));
+
+    printf("  \"set_locale\": %.2f,\n", measure(run_set_locale));
+    printf("  \"set_locale_by_idx\": %.2f,\n", measure(run_set_locale_by_idx));
+
+#ifndef LV_I18N_OPTIMIZE
+    printf("  \"singular_id\": %.2f,\n", measure(run_singular_id));
+    printf("  \"plural_id\": %.2f\n}\n", measure(run_plural_id));
+#else
+    /* IDs are resolved at compile time */
+    printf("  \"singular_id\": null,\n  \"plural_id\": null\n}\n");
+#endif
+
+    return sink == 0xffffffffu;
+}
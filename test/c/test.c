@@ -56,6 +56,58 @@ void test_set_locale_should_fail_not_existing(void)
     TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "en-GB");
 }
 
+void test_set_locale_should_ignore_case_and_separator(void)
+{
+    lv_i18n_init(lv_i18n_language_pack);
+
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale("RU_ru"), 0);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "ru-RU");
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale("de_DE"), 0);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "de-DE");
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale("en-gb"), 0);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "en-GB");
+}
+
+void test_set_locale_should_fallback_to_language(void)
+{
+    lv_i18n_init(lv_i18n_language_pack);
+
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale("ru"), 0);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "ru-RU");
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale("de-AT"), 0);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "de-DE");
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale("r"), -1);
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale("rus"), -1);
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale(""), -1);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "de-DE");
+}
+
+void test_set_locale_by_idx_should_work(void)
+{
+    lv_i18n_init(lv_i18n_language_pack);
+
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale_by_idx(LV_I18N_LOCALE_RU_RU), 0);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "ru-RU");
+    TEST_ASSERT_EQUAL_STRING(_("s_translated"), "s переведено");
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale_by_idx(LV_I18N_LOCALE_COUNT), -1);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "ru-RU");
+}
+
+void test_set_locale_best_match_should_work(void)
+{
+    lv_i18n_init(lv_i18n_language_pack);
+
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale_best_match("fr-FR, de;q=0.5, ru-RU;q=0.8, *;q=0.1"), 0);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "ru-RU");
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale_best_match("de-CH,ru;q=1.0"), 0);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "de-DE");
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale_best_match("fr ; q=0.9, *;q=0.001"), 0);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "en-GB");
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale_best_match("fr, ru;q=0"), -1);
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale_best_match(""), -1);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "en-GB");
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void test_get_text_should_work(void)
@@ -85,6 +137,101 @@ void test_get_text_should_fallback_to_orig(void)
     TEST_ASSERT_EQUAL_STRING(_("not existing"), "not existing");
 }
 
+#ifdef LV_I18N_OPTIMIZE
+// Literal with the same compile-time hash as "s_translated", for test data
+// weights. Update it if test data keys are changed.
+#define TEST_HASH_COLLISION "s_l@$!Erxxxx"
+
+void test_optimized_id_should_reject_hash_collision(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(LV_I18N_HASH(TEST_HASH_COLLISION), LV_I18N_HASH("s_translated"));
+    TEST_ASSERT_EQUAL(LV_I18N_ID_s(TEST_HASH_COLLISION), LV_I18N_ID_NOT_FOUND);
+    // The same length, with embedded '\0'
+    TEST_ASSERT_EQUAL(LV_I18N_ID_s("s_translate\0"), LV_I18N_ID_NOT_FOUND);
+
+    lv_i18n_init(lv_i18n_language_pack);
+    TEST_ASSERT_EQUAL_STRING(_(TEST_HASH_COLLISION), TEST_HASH_COLLISION);
+}
+#endif
+
+// One call site, for all locales
+static const char * cached_translated(void)
+{
+    return _i("s_translated");
+}
+
+void test_get_text_cached_should_follow_locale(void)
+{
+    const char * expected[] = { "s translated", "s переведено", "s translated" };
+    lv_i18n_ctx_t ctx;
+    int i, k;
+
+    lv_i18n_init(lv_i18n_language_pack);
+    lv_i18n_ctx_init(&ctx, lv_i18n_language_pack);
+
+    for(i = 0; i < 3; i++) {
+        lv_i18n_set_locale_by_idx((lv_i18n_locale_t)i);
+        lv_i18n_ctx_set_locale(&ctx, "ru-RU");
+
+        for(k = 0; k < 2; k++) TEST_ASSERT_EQUAL_STRING(cached_translated(), expected[i]);
+    }
+
+    TEST_ASSERT_EQUAL_STRING(_i("s_en_only"), "english only");
+    TEST_ASSERT_EQUAL_STRING(_i("not existing"), "not existing");
+
+    lv_i18n_set_locale("ru-RU");
+    lv_i18n_init(lv_i18n_language_pack);
+    TEST_ASSERT_EQUAL_STRING(cached_translated(), "s translated");
+}
+
+#if defined(__GNUC__) && !defined(LV_I18N_COMPRESS)
+void test_get_text_cache_should_follow_generation(void)
+{
+    lv_i18n_cache_t a = { NULL, 0, 0 };
+
+    TEST_ASSERT_NULL(lv_i18n_cache_get(&a));
+
+    lv_i18n_init(lv_i18n_language_pack);
+    lv_i18n_cache_fill(&a, "s_translated", LV_I18N_ID_s("s_translated"));
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_cache_get(&a), "s translated");
+    TEST_ASSERT_EQUAL(a.seq, 2);
+
+    lv_i18n_set_locale("ru-RU");
+    TEST_ASSERT_NULL(lv_i18n_cache_get(&a));
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_cache_fill(&a, "s_translated", LV_I18N_ID_s("s_translated")), "s переведено");
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_cache_get(&a), "s переведено");
+
+    // Empty entries never match, even after wrap
+    lv_i18n_generation = UINTPTR_MAX;
+    lv_i18n_set_locale("en-GB");
+    TEST_ASSERT_EQUAL(lv_i18n_generation, 1);
+    a.gen = 0;
+    TEST_ASSERT_NULL(lv_i18n_cache_get(&a));
+}
+
+void test_get_text_cache_should_skip_entry_being_written(void)
+{
+    lv_i18n_cache_t a = { NULL, 0, 0 };
+
+    lv_i18n_init(lv_i18n_language_pack);
+    lv_i18n_cache_fill(&a, "s_translated", LV_I18N_ID_s("s_translated"));
+
+    // Another thread is between counter updates: readers miss, writers
+    // get translation, but leave entry as is
+    a.seq++;
+    TEST_ASSERT_NULL(lv_i18n_cache_get(&a));
+
+    lv_i18n_set_locale("ru-RU");
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_cache_fill(&a, "s_translated", LV_I18N_ID_s("s_translated")), "s переведено");
+    TEST_ASSERT_EQUAL_STRING(a.str, "s translated");
+    TEST_ASSERT_EQUAL(a.seq, 3);
+
+    // Written, but for old locale
+    a.seq++;
+    TEST_ASSERT_NULL(lv_i18n_cache_get(&a));
+}
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void test_get_text_plural_should_work(void)
@@ -98,6 +245,9 @@ void test_get_text_plural_should_work(void)
     TEST_ASSERT_EQUAL_STRING(_p("p_i_have_dogs", 1), "У меня %d собакен");
     TEST_ASSERT_EQUAL_STRING(_p("p_i_have_dogs", 2), "У меня %d собакена");
     TEST_ASSERT_EQUAL_STRING(_p("p_i_have_dogs", 5), "У меня %d собакенов");
+    TEST_ASSERT_EQUAL_STRING(_p("p_i_have_dogs", 1001), "У меня %d собакен");
+    TEST_ASSERT_EQUAL_STRING(_p("p_i_have_dogs", 1022), "У меня %d собакена");
+    TEST_ASSERT_EQUAL_STRING(_p("p_i_have_dogs", 1012), "У меня %d собакенов");
 }
 
 void test_get_text_plural_should_fallback_to_base(void)
@@ -132,6 +282,101 @@ void test_get_text_plural_should_fallback_to_orig(void)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#ifndef LV_I18N_COMPRESS
+void test_get_text_batch_should_work(void)
+{
+    const uint16_t idx[] = {
+        (uint16_t)LV_I18N_ID_s("s_translated"),
+        (uint16_t)LV_I18N_ID_s("s_en_only"),
+        (uint16_t)LV_I18N_ID_s("s_untranslated"),
+        LV_I18N_ID_NOT_FOUND
+    };
+    const char * out[4];
+
+    __lv_i18n_reset();
+    TEST_ASSERT_EQUAL(lv_i18n_get_singular_batch(idx, 4, out), 4);
+    TEST_ASSERT_NULL(out[0]);
+
+    lv_i18n_init(lv_i18n_language_pack);
+    lv_i18n_set_locale("ru-RU");
+    TEST_ASSERT_EQUAL(lv_i18n_get_singular_batch(idx, 4, out), 2);
+    TEST_ASSERT_EQUAL_STRING(out[0], "s переведено");
+    TEST_ASSERT_EQUAL_STRING(out[1], "english only");
+    TEST_ASSERT_NULL(out[2]);
+    TEST_ASSERT_NULL(out[3]);
+
+    // The same as one by one
+    lv_i18n_set_locale("de-DE");
+    TEST_ASSERT_EQUAL(lv_i18n_get_singular_batch(idx, 2, out), 0);
+    TEST_ASSERT_EQUAL_STRING(out[0], _("s_translated"));
+    TEST_ASSERT_EQUAL_STRING(out[1], _("s_en_only"));
+}
+
+void test_get_text_plural_batch_should_work(void)
+{
+    const uint16_t idx[] = {
+        (uint16_t)LV_I18N_ID_p("p_i_have_dogs"),
+        (uint16_t)LV_I18N_ID_p("p_i_have_dogs"),
+        (uint16_t)LV_I18N_ID_p("p_i_have_dogs"),
+        LV_I18N_ID_NOT_FOUND
+    };
+    const int32_t num[] = { 1, 2, 5, 1 };
+    const char * out[4];
+    lv_i18n_ctx_t ctx;
+
+    lv_i18n_init(lv_i18n_language_pack);
+    lv_i18n_ctx_init(&ctx, lv_i18n_language_pack);
+    lv_i18n_ctx_set_locale(&ctx, "ru-RU");
+
+    TEST_ASSERT_EQUAL(lv_i18n_ctx_get_plural_batch(&ctx, idx, num, 4, out), 1);
+    TEST_ASSERT_EQUAL_STRING(out[0], "У меня %d собакен");
+    TEST_ASSERT_EQUAL_STRING(out[1], "У меня %d собакена");
+    TEST_ASSERT_EQUAL_STRING(out[2], "У меня %d собакенов");
+    TEST_ASSERT_NULL(out[3]);
+
+    // Default context is not touched
+    TEST_ASSERT_EQUAL(lv_i18n_get_plural_batch(idx, num, 3, out), 0);
+    TEST_ASSERT_EQUAL_STRING(out[0], "I have %d dog");
+    TEST_ASSERT_EQUAL_STRING(out[2], "I have %d dogs");
+
+    // Fallback to base locale
+    lv_i18n_set_locale("de-DE");
+    TEST_ASSERT_EQUAL(lv_i18n_get_plural_batch(idx, num, 3, out), 0);
+    TEST_ASSERT_EQUAL_STRING(out[1], "I have %d dogs");
+}
+
+#ifdef LV_I18N_SCREEN_SINGULARS_test
+// Phrases of this file, written by `--screens` option
+void test_screen_batch_should_match_single_lookups(void)
+{
+    static const uint16_t singulars[] = LV_I18N_SCREEN_SINGULARS_test;
+    static const uint16_t plurals[] = LV_I18N_SCREEN_PLURALS_test;
+    const char * out[sizeof(singulars) / sizeof(singulars[0])];
+    int32_t num[sizeof(plurals) / sizeof(plurals[0])];
+    size_t i;
+
+    lv_i18n_init(lv_i18n_language_pack);
+    lv_i18n_set_locale("ru-RU");
+
+    lv_i18n_get_singular_batch(singulars, sizeof(singulars) / sizeof(singulars[0]), out);
+
+    for(i = 0; i < sizeof(singulars) / sizeof(singulars[0]); i++) {
+        TEST_ASSERT_EQUAL_STRING(out[i] != NULL ? out[i] : "", lv_i18n_get_singular_by_idx("", singulars[i]));
+    }
+
+    for(i = 0; i < sizeof(plurals) / sizeof(plurals[0]); i++) num[i] = (int32_t)i + 1;
+
+    lv_i18n_get_plural_batch(plurals, num, sizeof(plurals) / sizeof(plurals[0]), out);
+
+    for(i = 0; i < sizeof(plurals) / sizeof(plurals[0]); i++) {
+        TEST_ASSERT_EQUAL_STRING(out[i] != NULL ? out[i] : "", lv_i18n_get_plural_by_idx("", plurals[i], num[i]));
+    }
+}
+#endif
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
 void test_should_fallback_without_langpack(void)
 {
     __lv_i18n_reset();
@@ -169,6 +414,13 @@ void test_empty_base_tables_fallback(void)
     lv_i18n_set_locale("ru-RU");
     TEST_ASSERT_EQUAL_STRING(_("not existing"), "not existing");
 
+    // Custom pack, without sorted index
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale_by_idx(LV_I18N_LOCALE_EN_GB), 0);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "en-GB");
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale("RU"), 0);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "ru-RU");
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale_by_idx(LV_I18N_LOCALE_DE_DE), -1);
+
     lv_i18n_init(fake_language_pack);
     TEST_ASSERT_EQUAL_STRING(_p("not existing", 1), "not existing");
     TEST_ASSERT_EQUAL_STRING(_p("not existing", 2), "not existing");
@@ -215,11 +467,19 @@ void test_empty_plurals_fallback(void)
 
 void test_empty_content_check(void)
 {
+#ifdef LV_I18N_STRING_POOL
+    static const lv_i18n_pool_offset_t en_gb_singulars[] = {
+         0, // 1=s_en_only
+         0, // 2=s_translated
+         0, // 3="s_untranslated"
+    };
+#else
     static const char * en_gb_singulars[] = {
          NULL, // 1=s_en_only
          NULL, // 2=s_translated
          NULL, // 3="s_untranslated"
     };
+#endif
 
     static const lv_i18n_lang_t en_gb_lang = {
         .locale_name = "en-GB",
@@ -237,6 +497,667 @@ void test_empty_content_check(void)
     TEST_ASSERT_EQUAL_STRING(_("s_empty"), "s_empty");
 }
 
+#ifndef LV_I18N_COMPRESS
+// Hand-written pack is not resolved by compiler, fallback must work in runtime
+void test_custom_pack_should_fallback_to_base(void)
+{
+    int i;
+#ifdef LV_I18N_STRING_POOL
+    static const char pool[] = "\0base";
+    lv_i18n_pool_offset_t en_gb_singulars[LV_I18N_SINGULAR_COUNT];
+
+    for(i = 0; i < LV_I18N_SINGULAR_COUNT; i++) en_gb_singulars[i] = 1;
+#else
+    const char * en_gb_singulars[LV_I18N_SINGULAR_COUNT];
+
+    for(i = 0; i < LV_I18N_SINGULAR_COUNT; i++) en_gb_singulars[i] = "base";
+#endif
+
+    const lv_i18n_lang_t en_gb_lang = {
+        .locale_name = "en-GB",
+#ifdef LV_I18N_STRING_POOL
+        .pool = pool,
+#endif
+        .singulars = en_gb_singulars,
+        .locale_plural_fn = fake_plural_fn
+    };
+
+    const lv_i18n_lang_t ru_ru_lang = {
+        .locale_name = "ru-RU",
+        .locale_plural_fn = fake_plural_fn
+    };
+
+    const lv_i18n_language_pack_t fake_language_pack[] = {
+        &en_gb_lang,
+        &ru_ru_lang,
+        NULL
+    };
+
+    lv_i18n_init(fake_language_pack);
+    lv_i18n_set_locale("ru-RU");
+    TEST_ASSERT_EQUAL_STRING(_("s_translated"), "base");
+    TEST_ASSERT_EQUAL_STRING(_("not existing"), "not existing");
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+void test_contexts_should_be_independent(void)
+{
+    lv_i18n_ctx_t ctx1, ctx2;
+
+    lv_i18n_init(lv_i18n_language_pack);
+    TEST_ASSERT_EQUAL(lv_i18n_ctx_init(&ctx1, NULL), -1);
+    TEST_ASSERT_EQUAL(lv_i18n_ctx_init(&ctx1, lv_i18n_language_pack), 0);
+    TEST_ASSERT_EQUAL(lv_i18n_ctx_init(&ctx2, lv_i18n_language_pack), 0);
+
+    TEST_ASSERT_EQUAL(lv_i18n_ctx_set_locale(&ctx1, "ru-RU"), 0);
+    TEST_ASSERT_EQUAL(lv_i18n_ctx_set_locale(&ctx2, "invalid"), -1);
+
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_ctx_get_current_locale(&ctx1), "ru-RU");
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_ctx_get_current_locale(&ctx2), "en-GB");
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "en-GB");
+
+    TEST_ASSERT_EQUAL_STRING(_c(&ctx1, "s_translated"), "s переведено");
+    TEST_ASSERT_EQUAL_STRING(_c(&ctx2, "s_translated"), "s translated");
+    TEST_ASSERT_EQUAL_STRING(_("s_translated"), "s translated");
+    TEST_ASSERT_EQUAL_STRING(_c(&ctx1, "s_en_only"), "english only");
+    TEST_ASSERT_EQUAL_STRING(_c(&ctx1, "not existing"), "not existing");
+
+    TEST_ASSERT_EQUAL_STRING(_cp(&ctx1, "p_i_have_dogs", 5), "У меня %d собакенов");
+    TEST_ASSERT_EQUAL_STRING(_cp(&ctx2, "p_i_have_dogs", 5), "I have %d dogs");
+    TEST_ASSERT_EQUAL_STRING(_cp(&ctx1, "not_existing", 5), "not_existing");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static lv_i18n_locale_change_t last_change;
+
+static void on_locale_change(const lv_i18n_locale_change_t * change, void * user_data)
+{
+    last_change = *change;
+    (*(int *)user_data)++;
+}
+
+void test_locale_change_cb_should_work(void)
+{
+    int calls = 0;
+
+    __lv_i18n_reset();
+    lv_i18n_init(lv_i18n_language_pack);
+    TEST_ASSERT_EQUAL(lv_i18n_add_locale_change_cb(on_locale_change, &calls), 0);
+
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale("ru-RU"), 0);
+    TEST_ASSERT_EQUAL(calls, 1);
+    TEST_ASSERT_EQUAL_STRING(last_change.old_locale, "en-GB");
+    TEST_ASSERT_EQUAL_STRING(last_change.new_locale, "ru-RU");
+
+    // Not changed
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale("ru-RU"), 0);
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale("invalid"), -1);
+    TEST_ASSERT_EQUAL(calls, 1);
+
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale_by_idx(LV_I18N_LOCALE_DE_DE), 0);
+    TEST_ASSERT_EQUAL(calls, 2);
+
+    TEST_ASSERT_EQUAL(lv_i18n_remove_locale_change_cb(on_locale_change, &calls), 0);
+    TEST_ASSERT_EQUAL(lv_i18n_remove_locale_change_cb(on_locale_change, &calls), -1);
+    lv_i18n_set_locale("en-GB");
+    TEST_ASSERT_EQUAL(calls, 2);
+}
+
+void test_locale_change_should_mark_changed_phrases(void)
+{
+    int calls = 0;
+
+    __lv_i18n_reset();
+    lv_i18n_init(lv_i18n_language_pack);
+    lv_i18n_add_locale_change_cb(on_locale_change, &calls);
+
+    lv_i18n_set_locale("ru-RU");
+    TEST_ASSERT_EQUAL(lv_i18n_is_singular_changed(&last_change, "s_translated"), 1);
+    TEST_ASSERT_EQUAL(lv_i18n_is_plural_changed(&last_change, "p_i_have_dogs"), 1);
+    TEST_ASSERT_EQUAL(lv_i18n_is_singular_changed(&last_change, "not existing"), 0);
+
+#ifdef LV_I18N_LOCALE_DIFF
+    // Fallbacks to base locale & msg_id
+    TEST_ASSERT_EQUAL(last_change.all, 0);
+    TEST_ASSERT_EQUAL(lv_i18n_is_singular_changed(&last_change, "s_en_only"), 0);
+    TEST_ASSERT_EQUAL(lv_i18n_is_singular_changed(&last_change, "s_untranslated"), 0);
+
+    // Everything in de-DE is taken from base locale
+    lv_i18n_set_locale("en-GB");
+    lv_i18n_set_locale("de-DE");
+    TEST_ASSERT_EQUAL(calls, 3);
+    TEST_ASSERT_NULL(last_change.diff);
+    TEST_ASSERT_EQUAL(lv_i18n_is_singular_changed(&last_change, "s_translated"), 0);
+    TEST_ASSERT_EQUAL(lv_i18n_is_plural_changed(&last_change, "p_i_have_dogs"), 0);
+
+    // Diff is the same in both directions
+    lv_i18n_set_locale("ru-RU");
+    TEST_ASSERT_EQUAL(lv_i18n_is_singular_changed(&last_change, "s_translated"), 1);
+    TEST_ASSERT_EQUAL(lv_i18n_is_singular_changed(&last_change, "s_en_only"), 0);
+#else
+    // Without diff, any text may be changed
+    TEST_ASSERT_EQUAL(last_change.all, 1);
+    TEST_ASSERT_EQUAL(lv_i18n_is_singular_changed(&last_change, "s_en_only"), 1);
+#endif
+
+    lv_i18n_remove_locale_change_cb(on_locale_change, &calls);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void test_format_should_work(void)
+{
+    char buf[64];
+
+    lv_i18n_init(lv_i18n_language_pack);
+
+    TEST_ASSERT_EQUAL(lv_i18n_format(buf, sizeof(buf), "s_dogs_of", "Bob", 5), 14);
+    TEST_ASSERT_EQUAL_STRING(buf, "Dogs of Bob: 5");
+    TEST_ASSERT_EQUAL(lv_i18n_format_plural(buf, sizeof(buf), "p_i_have_dogs", 1, 1), 12);
+    TEST_ASSERT_EQUAL_STRING(buf, "I have 1 dog");
+
+    // Reordered arguments
+    lv_i18n_set_locale("ru-RU");
+    lv_i18n_format(buf, sizeof(buf), "s_dogs_of", "Bob", 5);
+    TEST_ASSERT_EQUAL_STRING(buf, "5 собакенов у Bob");
+    lv_i18n_format_plural(buf, sizeof(buf), "p_i_have_dogs", 3, 3);
+    TEST_ASSERT_EQUAL_STRING(buf, "У меня 3 собакена");
+
+    // Fallbacks
+    lv_i18n_format(buf, sizeof(buf), "s_en_only");
+    TEST_ASSERT_EQUAL_STRING(buf, "english only");
+    lv_i18n_format(buf, sizeof(buf), "not existing %d", -12);
+    TEST_ASSERT_EQUAL_STRING(buf, "not existing -12");
+    lv_i18n_set_locale("de-DE");
+    lv_i18n_format_plural(buf, sizeof(buf), "p_i_have_dogs", 5, 5);
+    TEST_ASSERT_EQUAL_STRING(buf, "I have 5 dogs");
+}
+
+void test_format_should_truncate(void)
+{
+    char buf[8];
+
+    lv_i18n_init(lv_i18n_language_pack);
+
+    memset(buf, 'x', sizeof(buf));
+    TEST_ASSERT_EQUAL(lv_i18n_format(buf, sizeof(buf), "s_dogs_of", "Bob", 5), 14);
+    TEST_ASSERT_EQUAL_STRING(buf, "Dogs of");
+    TEST_ASSERT_EQUAL(lv_i18n_format(buf, 1, "s_dogs_of", "Bob", 5), 14);
+    TEST_ASSERT_EQUAL_STRING(buf, "");
+    TEST_ASSERT_EQUAL(lv_i18n_format(NULL, 0, "s_dogs_of", "Bob", 12345), 18);
+}
+
+void test_format_should_support_specs(void)
+{
+    char buf[64];
+
+    lv_i18n_init(lv_i18n_language_pack);
+
+    // Not existing phrases are formatted as is
+    lv_i18n_format(buf, sizeof(buf), "%%|%5.2f|%-3s|%x|%ld|%zu|%c|%u|%q|%", 1.5, "ab", 255u, -7L, (size_t)42, 'z', 7u);
+    TEST_ASSERT_EQUAL_STRING(buf, "%| 1.50|ab |ff|-7|42|z|7|%q|%");
+    lv_i18n_format(buf, sizeof(buf), "%3$s %1$d %2$s, %1$03d", 1, "two", "three");
+    TEST_ASSERT_EQUAL_STRING(buf, "three 1 two, 001");
+    lv_i18n_format(buf, sizeof(buf), "%lld %llu %hd", -1234567890123LL, 1234567890123ULL, 5);
+    TEST_ASSERT_EQUAL_STRING(buf, "-1234567890123 1234567890123 5");
+}
+
+#ifndef LV_I18N_COMPRESS
+// Formats of custom pack are parsed in runtime, even with `--format-tokens`
+void test_format_should_take_skipped_type_from_base(void)
+{
+    char buf[64];
+    int i;
+#ifdef LV_I18N_STRING_POOL
+    static const char pool[] = "\0%s has %d dogs\0%2$d dogs";
+    lv_i18n_pool_offset_t en_gb_singulars[LV_I18N_SINGULAR_COUNT];
+    lv_i18n_pool_offset_t ru_ru_singulars[LV_I18N_SINGULAR_COUNT];
+
+    for(i = 0; i < LV_I18N_SINGULAR_COUNT; i++) {
+        en_gb_singulars[i] = 1;
+        ru_ru_singulars[i] = 16;
+    }
+#else
+    const char * en_gb_singulars[LV_I18N_SINGULAR_COUNT];
+    const char * ru_ru_singulars[LV_I18N_SINGULAR_COUNT];
+
+    for(i = 0; i < LV_I18N_SINGULAR_COUNT; i++) {
+        en_gb_singulars[i] = "%s has %d dogs";
+        ru_ru_singulars[i] = "%2$d dogs";
+    }
+#endif
+
+    const lv_i18n_lang_t en_gb_lang = {
+        .locale_name = "en-GB",
+#ifdef LV_I18N_STRING_POOL
+        .pool = pool,
+#endif
+        .singulars = en_gb_singulars,
+        .locale_plural_fn = fake_plural_fn
+    };
+
+    const lv_i18n_lang_t ru_ru_lang = {
+        .locale_name = "ru-RU",
+#ifdef LV_I18N_STRING_POOL
+        .pool = pool,
+#endif
+        .singulars = ru_ru_singulars,
+        .locale_plural_fn = fake_plural_fn
+    };
+
+    const lv_i18n_language_pack_t fake_language_pack[] = {
+        &en_gb_lang,
+        &ru_ru_lang,
+        NULL
+    };
+
+    lv_i18n_init(fake_language_pack);
+    lv_i18n_set_locale("ru-RU");
+
+    // "%1$s" is skipped, but still must be read from arguments
+    TEST_ASSERT_EQUAL(lv_i18n_format(buf, sizeof(buf), "s_dogs_of", "Bob", 5), 6);
+    TEST_ASSERT_EQUAL_STRING(buf, "5 dogs");
+}
+#endif
+
+void test_format_should_work_in_context(void)
+{
+    lv_i18n_ctx_t ctx;
+    char buf[64];
+
+    lv_i18n_init(lv_i18n_language_pack);
+    lv_i18n_ctx_init(&ctx, lv_i18n_language_pack);
+    lv_i18n_ctx_set_locale(&ctx, "ru-RU");
+
+    lv_i18n_ctx_format(&ctx, buf, sizeof(buf), "s_dogs_of", "Bob", 5);
+    TEST_ASSERT_EQUAL_STRING(buf, "5 собакенов у Bob");
+    lv_i18n_ctx_format_plural(&ctx, buf, sizeof(buf), "p_i_have_dogs", 21, 21);
+    TEST_ASSERT_EQUAL_STRING(buf, "У меня 21 собакен");
+    lv_i18n_format(buf, sizeof(buf), "s_dogs_of", "Bob", 5);
+    TEST_ASSERT_EQUAL_STRING(buf, "Dogs of Bob: 5");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef LV_I18N_STATS
+
+static int miss_count;
+static lv_i18n_miss_t last_miss;
+
+static void on_miss(const char * locale __attribute__((unused)), const char * msg_id __attribute__((unused)),
+                    int plural __attribute__((unused)), lv_i18n_miss_t reason)
+{
+    miss_count++;
+    last_miss = reason;
+}
+
+static char dump[1024];
+
+static void dump_line(const char * line)
+{
+    strcat(dump, line);
+    strcat(dump, "\n");
+}
+
+void test_stats_should_count_lookups(void)
+{
+    const lv_i18n_stats_t * stats = lv_i18n_stats_get();
+
+    lv_i18n_init(lv_i18n_language_pack);
+    lv_i18n_stats_reset();
+    lv_i18n_set_miss_callback(on_miss);
+    miss_count = 0;
+
+    _("s_translated");
+    TEST_ASSERT_EQUAL(miss_count, 0);
+
+    lv_i18n_set_locale("ru-RU");
+    _("s_translated");
+    _p("p_i_have_dogs", 5);
+    _("s_en_only");
+    TEST_ASSERT_EQUAL(miss_count, 1);
+    TEST_ASSERT_EQUAL(last_miss, LV_I18N_MISS_FALLBACK);
+    _("s_untranslated");
+    TEST_ASSERT_EQUAL(last_miss, LV_I18N_MISS_UNTRANSLATED);
+    _("not existing");
+    TEST_ASSERT_EQUAL(last_miss, LV_I18N_MISS_UNKNOWN);
+
+    lv_i18n_set_locale("de-DE");
+    _p("p_i_have_dogs", 5);
+    TEST_ASSERT_EQUAL(miss_count, 4);
+
+    TEST_ASSERT_EQUAL(stats->locales[LV_I18N_LOCALE_EN_GB].hits, 1);
+    TEST_ASSERT_EQUAL(stats->locales[LV_I18N_LOCALE_RU_RU].hits, 2);
+    TEST_ASSERT_EQUAL(stats->locales[LV_I18N_LOCALE_RU_RU].fallbacks, 1);
+    TEST_ASSERT_EQUAL(stats->locales[LV_I18N_LOCALE_RU_RU].misses, 2);
+    TEST_ASSERT_EQUAL(stats->locales[LV_I18N_LOCALE_DE_DE].fallbacks, 1);
+    TEST_ASSERT_EQUAL(stats->singulars[LV_I18N_ID_s("s_translated")].hits, 2);
+    TEST_ASSERT_EQUAL(stats->singulars[LV_I18N_ID_s("s_en_only")].fallbacks, 1);
+    TEST_ASSERT_EQUAL(stats->singulars[LV_I18N_ID_s("s_untranslated")].misses, 1);
+    TEST_ASSERT_EQUAL(stats->plurals[LV_I18N_ID_p("p_i_have_dogs")].hits, 1);
+    TEST_ASSERT_EQUAL(stats->plurals[LV_I18N_ID_p("p_i_have_dogs")].fallbacks, 1);
+    TEST_ASSERT_EQUAL(stats->not_found, 1);
+
+    lv_i18n_set_miss_callback(NULL);
+    lv_i18n_stats_reset();
+    TEST_ASSERT_EQUAL(stats->locales[LV_I18N_LOCALE_RU_RU].hits, 0);
+}
+
+void test_stats_should_dump(void)
+{
+    lv_i18n_init(lv_i18n_language_pack);
+    lv_i18n_stats_reset();
+
+    lv_i18n_set_locale("ru-RU");
+    _("s_translated");
+    _("s_en_only");
+
+    dump[0] = '\0';
+    lv_i18n_stats_dump(dump_line);
+
+    TEST_ASSERT_NOT_NULL(strstr(dump, "locale \"ru-RU\": hits 1, fallbacks 1, misses 0, time "));
+    TEST_ASSERT_NOT_NULL(strstr(dump, "singular \"s_en_only\": hits 0, fallbacks 1, misses 0, time "));
+    TEST_ASSERT_NULL(strstr(dump, "en-GB"));
+    TEST_ASSERT_NOT_NULL(strstr(dump, "unknown phrases: 0\n"));
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef LV_I18N_STRING_INFO
+
+void test_string_info_should_be_precomputed(void)
+{
+    lv_i18n_str_info_t info;
+
+    lv_i18n_init(lv_i18n_language_pack);
+    lv_i18n_set_locale("ru-RU");
+
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_singular_info("s_translated", &info), "s переведено");
+    TEST_ASSERT_EQUAL(info.len, 22);
+    TEST_ASSERT_EQUAL(info.chars, 12);
+    TEST_ASSERT_EQUAL_UINT32(info.hash, 0x81f307c9);
+
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_plural_info("p_i_have_dogs", 1, &info), "У меня %d собакен");
+    TEST_ASSERT_EQUAL(info.len, 29);
+    TEST_ASSERT_EQUAL(info.chars, 17);
+    TEST_ASSERT_EQUAL_UINT32(info.hash, 0xa5ae30aa);
+
+    // Fallback to base locale takes its metadata
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_singular_info("s_en_only", &info), "english only");
+    TEST_ASSERT_EQUAL(info.len, 12);
+    TEST_ASSERT_EQUAL(info.chars, 12);
+    TEST_ASSERT_EQUAL_UINT32(info.hash, 0x7f105dfb);
+}
+
+void test_string_info_should_be_calculated_for_not_translated(void)
+{
+    lv_i18n_str_info_t info;
+
+    lv_i18n_init(lv_i18n_language_pack);
+    lv_i18n_set_locale("ru-RU");
+
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_singular_info("s_untranslated", &info), "s_untranslated");
+    TEST_ASSERT_EQUAL(info.len, 14);
+    TEST_ASSERT_EQUAL(info.chars, 14);
+    TEST_ASSERT_EQUAL_UINT32(info.hash, 0xec90f05e);
+
+    // Metadata is optional
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_singular_info("s_translated", NULL), "s переведено");
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef LV_I18N_BINARY
+
+static uint8_t pack[4096];
+
+static size_t read_pack(void)
+{
+    size_t size;
+    FILE * f = fopen(TEST_PACK_PATH, "rb");
+
+    TEST_ASSERT_NOT_NULL(f);
+    size = fread(pack, 1, sizeof(pack), f);
+    fclose(f);
+
+    return size;
+}
+
+// Update checksum after pack edit, to check other validations
+static void sign_pack(size_t size)
+{
+    uint32_t h = 0x811c9dc5u;
+    size_t i;
+
+    for(i = 16; i < size; i++) {
+        h ^= pack[i];
+        h *= 0x01000193u;
+    }
+    for(i = 0; i < 4; i++) pack[12 + i] = (uint8_t)(h >> (i * 8));
+}
+
+void test_binary_pack_should_work(void)
+{
+    size_t size = read_pack();
+    const uint16_t ids[] = {
+        (uint16_t)LV_I18N_ID_s("s_translated"),
+        (uint16_t)LV_I18N_ID_s("s_untranslated"),
+        (uint16_t)LV_I18N_ID_p("p_i_have_dogs"),
+        (uint16_t)LV_I18N_ID_p("p_i_have_dogs")
+    };
+    const int32_t nums[] = { 1, 5 };
+    const char * out[2];
+
+    lv_i18n_init(lv_i18n_language_pack);
+    TEST_ASSERT_EQUAL(lv_i18n_load_pack_from_memory(pack, size), 0);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "en-GB");
+
+    TEST_ASSERT_EQUAL_STRING(_("s_translated"), "s translated (pack)");
+    TEST_ASSERT_EQUAL_STRING(_("s_untranslated"), "s_untranslated");
+    TEST_ASSERT_EQUAL_STRING(_("not existing"), "not existing");
+    TEST_ASSERT_EQUAL_STRING(_p("p_i_have_dogs", 1), "I have %d dog");
+    TEST_ASSERT_EQUAL_STRING(_p("p_i_have_dogs", 5), "I have %d dogs (pack)");
+
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale("ru-RU"), 0);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "ru-RU");
+    TEST_ASSERT_EQUAL_STRING(_("s_translated"), "s переведено");
+    TEST_ASSERT_EQUAL_STRING(_("s_en_only"), "english only");
+    TEST_ASSERT_EQUAL_STRING(_p("p_i_have_dogs", 1), "У меня %d собакен");
+    TEST_ASSERT_EQUAL_STRING(_p("p_i_have_dogs", 3), "У меня %d собакена");
+    TEST_ASSERT_EQUAL_STRING(_p("p_i_have_dogs", 11), "У меня %d собакенов");
+    TEST_ASSERT_EQUAL_STRING(_p("p_i_have_dogs", 21), "У меня %d собакен");
+
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale("en"), 0);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "en-GB");
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale_by_idx(LV_I18N_LOCALE_RU_RU), 0);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "ru-RU");
+
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale("DE_de"), 0);
+    TEST_ASSERT_EQUAL_STRING(_("s_translated"), "s translated (pack)");
+    TEST_ASSERT_EQUAL_STRING(_p("p_i_have_dogs", 5), "I have %d dogs (pack)");
+
+    TEST_ASSERT_EQUAL(lv_i18n_get_singular_batch(ids, 2, out), 1);
+    TEST_ASSERT_EQUAL_STRING(out[0], "s translated (pack)");
+    TEST_ASSERT_NULL(out[1]);
+    TEST_ASSERT_EQUAL(lv_i18n_get_plural_batch(ids + 2, nums, 2, out), 0);
+    TEST_ASSERT_EQUAL_STRING(out[0], "I have %d dog");
+    TEST_ASSERT_EQUAL_STRING(out[1], "I have %d dogs (pack)");
+
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale("invalid"), -1);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "de-DE");
+
+    // Back to compiled translations
+    lv_i18n_init(lv_i18n_language_pack);
+    TEST_ASSERT_EQUAL_STRING(_("s_translated"), "s translated");
+}
+
+void test_binary_pack_should_reject_damaged(void)
+{
+    size_t size = read_pack();
+
+    lv_i18n_init(lv_i18n_language_pack);
+
+    TEST_ASSERT_EQUAL(lv_i18n_load_pack_from_memory(NULL, size), -1);
+    TEST_ASSERT_EQUAL(lv_i18n_load_pack_from_memory(pack, 16), -1);
+    TEST_ASSERT_EQUAL(lv_i18n_load_pack_from_memory(pack, size - 1), -1);
+
+    // Broken data
+    pack[size - 2] ^= 1;
+    TEST_ASSERT_EQUAL(lv_i18n_load_pack_from_memory(pack, size), -1);
+    pack[size - 2] ^= 1;
+
+    // Pack for another phrases
+    pack[16] ^= 1;
+    TEST_ASSERT_EQUAL(lv_i18n_load_pack_from_memory(pack, size), -1);
+    pack[16] ^= 1;
+
+    // Same phrases, but tables are shorter than phrase IDs
+    pack[22]--;
+    sign_pack(size);
+    TEST_ASSERT_EQUAL(lv_i18n_load_pack_from_memory(pack, size), -1);
+    pack[22]++;
+    sign_pack(size);
+
+    // Locale record with wrong offset of itself
+    pack[pack[28] + 40] ^= 4;
+    sign_pack(size);
+    TEST_ASSERT_EQUAL(lv_i18n_load_pack_from_memory(pack, size), -1);
+    pack[pack[28] + 40] ^= 4;
+    sign_pack(size);
+
+    TEST_ASSERT_EQUAL(lv_i18n_load_pack_from_memory(pack, size), 0);
+
+    lv_i18n_init(lv_i18n_language_pack);
+}
+
+void test_binary_pack_should_work_in_context(void)
+{
+    lv_i18n_ctx_t ctx;
+    size_t size = read_pack();
+
+    lv_i18n_init(lv_i18n_language_pack);
+    lv_i18n_ctx_init(&ctx, lv_i18n_language_pack);
+    TEST_ASSERT_EQUAL(lv_i18n_ctx_load_pack_from_memory(&ctx, pack, size), 0);
+    TEST_ASSERT_EQUAL(lv_i18n_ctx_set_locale(&ctx, "ru-RU"), 0);
+
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_ctx_get_current_locale(&ctx), "ru-RU");
+    TEST_ASSERT_EQUAL_STRING(_cp(&ctx, "p_i_have_dogs", 3), "У меня %d собакена");
+    TEST_ASSERT_EQUAL_STRING(_c(&ctx, "s_en_only"), "english only");
+
+    // Default context still uses compiled translations
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "en-GB");
+    TEST_ASSERT_EQUAL_STRING(_("s_translated"), "s translated");
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef LV_I18N_COMPRESS
+
+// Built with cache of 2 strings
+void test_compressed_strings_should_stay_valid_in_cache(void)
+{
+    const char * translated;
+    const char * en_only;
+
+    TEST_ASSERT_EQUAL(LV_I18N_DECODE_CACHE_SIZE, 2);
+
+    __lv_i18n_reset();
+    lv_i18n_init(lv_i18n_language_pack);
+
+    translated = _("s_translated");
+    TEST_ASSERT_EQUAL_PTR(_("s_translated"), translated);
+
+    en_only = _("s_en_only");
+    TEST_ASSERT_EQUAL_STRING(translated, "s translated");
+    TEST_ASSERT_EQUAL_STRING(en_only, "english only");
+
+    // Least recently used one is replaced
+    TEST_ASSERT_EQUAL_PTR(_("s_translated"), translated);
+    TEST_ASSERT_EQUAL_STRING(_("s_dogs_of"), "Dogs of %s: %d");
+    TEST_ASSERT_EQUAL_STRING(translated, "s translated");
+    TEST_ASSERT_EQUAL_PTR(_("s_translated"), translated);
+    TEST_ASSERT_EQUAL_STRING(en_only, "Dogs of %s: %d");
+}
+
+void test_compressed_strings_should_decode_all_forms(void)
+{
+    lv_i18n_init(lv_i18n_language_pack);
+    lv_i18n_set_locale("ru-RU");
+
+    TEST_ASSERT_EQUAL_STRING(_p("p_i_have_dogs", 1), "У меня %d собакен");
+    TEST_ASSERT_EQUAL_STRING(_p("p_i_have_dogs", 2), "У меня %d собакена");
+    TEST_ASSERT_EQUAL_STRING(_p("p_i_have_dogs", 5), "У меня %d собакенов");
+    TEST_ASSERT_EQUAL_STRING(_("s_dogs_of"), "%2$d собакенов у %1$s");
+    TEST_ASSERT_EQUAL_STRING(_("s_en_only"), "english only");
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef LV_I18N_SPLIT
+
+void test_register_lang_should_require_base_first(void)
+{
+    __lv_i18n_reset();
+
+    TEST_ASSERT_EQUAL(lv_i18n_init(lv_i18n_language_pack), -1);
+    TEST_ASSERT_EQUAL(lv_i18n_register_lang(&lv_i18n_lang_ru_ru), -1);
+    TEST_ASSERT_EQUAL(lv_i18n_register_lang(&lv_i18n_lang_en_gb), 0);
+
+    TEST_ASSERT_EQUAL(lv_i18n_init(lv_i18n_language_pack), 0);
+    TEST_ASSERT_EQUAL_STRING(_("s_translated"), "s translated");
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale("ru-RU"), -1);
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale_by_idx(LV_I18N_LOCALE_RU_RU), -1);
+    TEST_ASSERT_EQUAL_STRING(lv_i18n_get_current_locale(), "en-GB");
+}
+
+void test_register_lang_should_reject_unknown(void)
+{
+    static const lv_i18n_lang_t unknown_lang = {
+        .locale_name = "xx-XX",
+        .keys_hash = LV_I18N_KEYS_HASH
+    };
+    static const lv_i18n_lang_t stale_lang = {
+        .locale_name = "de-DE",
+        .keys_hash = LV_I18N_KEYS_HASH + 1
+    };
+
+    TEST_ASSERT_EQUAL(lv_i18n_register_lang(NULL), -1);
+    TEST_ASSERT_EQUAL(lv_i18n_register_lang(&unknown_lang), -1);
+    TEST_ASSERT_EQUAL(lv_i18n_register_lang(&stale_lang), -1);
+    TEST_ASSERT_NULL(lv_i18n_language_pack[1]);
+}
+
+void test_register_lang_should_keep_id_order(void)
+{
+    TEST_ASSERT_EQUAL(lv_i18n_register_lang(&lv_i18n_lang_de_de), 0);
+    TEST_ASSERT_EQUAL(lv_i18n_register_lang(&lv_i18n_lang_ru_ru), 0);
+    TEST_ASSERT_EQUAL(lv_i18n_register_lang(&lv_i18n_lang_ru_ru), 0);
+
+    TEST_ASSERT_EQUAL_PTR(lv_i18n_language_pack[0], &lv_i18n_lang_en_gb);
+    TEST_ASSERT_EQUAL_PTR(lv_i18n_language_pack[1], &lv_i18n_lang_ru_ru);
+    TEST_ASSERT_EQUAL_PTR(lv_i18n_language_pack[2], &lv_i18n_lang_de_de);
+    TEST_ASSERT_NULL(lv_i18n_language_pack[3]);
+
+    lv_i18n_init(lv_i18n_language_pack);
+
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale_by_idx(LV_I18N_LOCALE_RU_RU), 0);
+    TEST_ASSERT_EQUAL_STRING(_("s_translated"), "s переведено");
+    TEST_ASSERT_EQUAL(lv_i18n_set_locale("de"), 0);
+    TEST_ASSERT_EQUAL_STRING(_("s_translated"), "s translated");
+}
+
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -245,6 +1166,13 @@ int main(void)
 {
     UNITY_BEGIN();
 
+#ifdef LV_I18N_SPLIT
+    // lv_i18n_register_lang, registers all locales for other tests
+    RUN_TEST(test_register_lang_should_require_base_first);
+    RUN_TEST(test_register_lang_should_reject_unknown);
+    RUN_TEST(test_register_lang_should_keep_id_order);
+#endif
+
     // lv_i18n_init
     RUN_TEST(test_init_should_ignore_NULL_input);
     RUN_TEST(test_init_should_ignore_empty_language_pack);
@@ -254,22 +1182,85 @@ int main(void)
     RUN_TEST(test_set_locale_should_fail_before_init);
     RUN_TEST(test_set_locale_should_work);
     RUN_TEST(test_set_locale_should_fail_not_existing);
+    RUN_TEST(test_set_locale_should_ignore_case_and_separator);
+    RUN_TEST(test_set_locale_should_fallback_to_language);
+    RUN_TEST(test_set_locale_by_idx_should_work);
+    RUN_TEST(test_set_locale_best_match_should_work);
 
     // lv_i18n_get_text
     RUN_TEST(test_get_text_should_work);
     RUN_TEST(test_get_text_should_fallback_to_base);
     RUN_TEST(test_get_text_should_fallback_to_orig);
+#ifdef LV_I18N_OPTIMIZE
+    RUN_TEST(test_optimized_id_should_reject_hash_collision);
+#endif
+    RUN_TEST(test_get_text_cached_should_follow_locale);
+#if defined(__GNUC__) && !defined(LV_I18N_COMPRESS)
+    RUN_TEST(test_get_text_cache_should_follow_generation);
+    RUN_TEST(test_get_text_cache_should_skip_entry_being_written);
+#endif
 
     // lv_i18n_get_plural_text
     RUN_TEST(test_get_text_plural_should_work);
     RUN_TEST(test_get_text_plural_should_fallback_to_base);
     RUN_TEST(test_get_text_plural_should_fallback_to_orig);
+#ifndef LV_I18N_COMPRESS
+    RUN_TEST(test_get_text_batch_should_work);
+    RUN_TEST(test_get_text_plural_batch_should_work);
+#ifdef LV_I18N_SCREEN_SINGULARS_test
+    RUN_TEST(test_screen_batch_should_match_single_lookups);
+#endif
+#endif
 
     // Other
     RUN_TEST(test_should_fallback_without_langpack);
     RUN_TEST(test_empty_base_tables_fallback);
     RUN_TEST(test_empty_plurals_fallback);
     RUN_TEST(test_empty_content_check);
+#ifndef LV_I18N_COMPRESS
+    RUN_TEST(test_custom_pack_should_fallback_to_base);
+#endif
+
+    // lv_i18n_ctx_*
+    RUN_TEST(test_contexts_should_be_independent);
+
+    // lv_i18n_add_locale_change_cb
+    RUN_TEST(test_locale_change_cb_should_work);
+    RUN_TEST(test_locale_change_should_mark_changed_phrases);
+
+    // lv_i18n_format
+    RUN_TEST(test_format_should_work);
+    RUN_TEST(test_format_should_truncate);
+    RUN_TEST(test_format_should_support_specs);
+    RUN_TEST(test_format_should_work_in_context);
+#ifndef LV_I18N_COMPRESS
+    RUN_TEST(test_format_should_take_skipped_type_from_base);
+#endif
+
+#ifdef LV_I18N_STATS
+    // lv_i18n_stats_*
+    RUN_TEST(test_stats_should_count_lookups);
+    RUN_TEST(test_stats_should_dump);
+#endif
+
+#ifdef LV_I18N_COMPRESS
+    // --compress
+    RUN_TEST(test_compressed_strings_should_stay_valid_in_cache);
+    RUN_TEST(test_compressed_strings_should_decode_all_forms);
+#endif
+
+#ifdef LV_I18N_STRING_INFO
+    // lv_i18n_get_singular_info, lv_i18n_get_plural_info
+    RUN_TEST(test_string_info_should_be_precomputed);
+    RUN_TEST(test_string_info_should_be_calculated_for_not_translated);
+#endif
+
+#ifdef LV_I18N_BINARY
+    // lv_i18n_load_pack_from_memory
+    RUN_TEST(test_binary_pack_should_work);
+    RUN_TEST(test_binary_pack_should_reject_damaged);
+    RUN_TEST(test_binary_pack_should_work_in_context);
+#endif
 
     return UNITY_END();
 }
@@ -0,0 +1,75 @@
+#include "unity.h"
+#include "lv_i18n.hpp"
+
+#include <cstring>
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Phrase IDs must be the same as in compiled tables
+static_assert(lv_i18n::detail::singular_id("s_translated") >= 0, "known singular");
+static_assert(lv_i18n::detail::singular_id("p_i_have_dogs") < 0, "plural is not singular");
+static_assert(lv_i18n::detail::plural_id("p_i_have_dogs") == 0, "the only plural");
+
+// Must fail to compile, checked by Makefile
+#ifdef TEST_CPP_UNKNOWN_PHRASE
+const char * test_cpp_unknown_phrase(void)
+{
+    return LV_I18N_TR("not existing");
+}
+#endif
+
+#ifdef TEST_CPP_PLURAL_AS_SINGULAR
+const char * test_cpp_plural_as_singular(void)
+{
+    return LV_I18N_TR("p_i_have_dogs");
+}
+#endif
+
+void test_cpp_ids_should_match_c(void)
+{
+    TEST_ASSERT_EQUAL(lv_i18n::detail::singular_id("s_translated"), lv_i18n_get_singular_id("s_translated"));
+    TEST_ASSERT_EQUAL(lv_i18n::detail::singular_id("s_en_only"), lv_i18n_get_singular_id("s_en_only"));
+    TEST_ASSERT_EQUAL(lv_i18n::detail::plural_id("p_i_have_dogs"), lv_i18n_get_plural_id("p_i_have_dogs"));
+}
+
+void test_cpp_macros_should_work(void)
+{
+    lv_i18n_init(lv_i18n_language_pack);
+    lv_i18n_set_locale("ru-RU");
+
+    TEST_ASSERT_EQUAL_STRING(LV_I18N_TR("s_translated"), "s переведено");
+    TEST_ASSERT_EQUAL_STRING(LV_I18N_TR("s_en_only"), "english only");
+    TEST_ASSERT_EQUAL_STRING(LV_I18N_TR("s_untranslated"), "s_untranslated");
+    TEST_ASSERT_EQUAL_STRING(LV_I18N_TRP("p_i_have_dogs", 5), "У меня %d собакенов");
+}
+
+#if __cplusplus >= 202002L
+void test_cpp_templates_should_work(void)
+{
+    using namespace lv_i18n::literals;
+    lv_i18n_ctx_t ctx;
+
+    lv_i18n_init(lv_i18n_language_pack);
+    lv_i18n_set_locale("ru-RU");
+    lv_i18n_ctx_init(&ctx, lv_i18n_language_pack);
+
+    TEST_ASSERT_EQUAL_STRING(lv_i18n::tr<"s_translated">(), "s переведено");
+    TEST_ASSERT_EQUAL_STRING(lv_i18n::tr<"s_translated">(&ctx), "s translated");
+    TEST_ASSERT_EQUAL_STRING(lv_i18n::trp<"p_i_have_dogs">(2), "У меня %d собакена");
+    TEST_ASSERT_EQUAL_STRING(lv_i18n::trp<"p_i_have_dogs">(&ctx, 2), "I have %d dogs");
+    TEST_ASSERT_EQUAL_STRING("s_en_only"_tr, "english only");
+}
+#endif
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_cpp_ids_should_match_c);
+    RUN_TEST(test_cpp_macros_should_work);
+#if __cplusplus >= 202002L
+    RUN_TEST(test_cpp_templates_should_work);
+#endif
+
+    return UNITY_END();
+}
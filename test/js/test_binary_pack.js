@@ -0,0 +1,108 @@
+'use strict';
+
+
+const assert  = require('assert');
+
+const { fnv1a } = require('../../lib/hash');
+const { create_binary_pack, keys_hash } = require('../../lib/binary_pack');
+const { form_codes, create_plural_bytecode, eval_plural_bytecode } = require('../../lib/plurals');
+
+
+const data = {
+  singularKeys: [ 'cancel', 'ok' ],
+  pluralKeys: [ 'files' ],
+  'en-GB': {
+    singular: { cancel: 'Cancel', ok: 'OK' },
+    plural: { one: { files: '%d file' }, other: { files: '%d files' } }
+  },
+  'ru-RU': {
+    singular: { cancel: 'Отмена' },
+    plural: { one: { files: '%d файл' }, few: { files: '%d файла' }, many: { files: '%d файлов' } }
+  }
+};
+
+function str(pack, offset) {
+  return offset ? pack.subarray(offset, pack.indexOf(0, offset)).toString() : null;
+}
+
+function locale(pack, idx) {
+  return pack.readUInt32LE(28) + idx * 44;
+}
+
+
+describe('Binary pack', function () {
+
+  it('Should write valid header', function () {
+    const pack = create_binary_pack([ 'en-GB', 'ru-RU' ], data);
+
+    assert.strictEqual(pack.subarray(0, 4).toString(), 'LVIP');
+    assert.strictEqual(pack.readUInt16LE(4), 2);
+    assert.strictEqual(pack.readUInt32LE(8), pack.length);
+    assert.strictEqual(pack.readUInt32LE(12), fnv1a(pack.subarray(16)));
+    assert.strictEqual(pack.readUInt32LE(16), keys_hash(data));
+    assert.strictEqual(pack.readUInt16LE(20), 2);
+    assert.strictEqual(pack.readUInt16LE(22), 1);
+    assert.strictEqual(pack.readUInt16LE(24), 2);
+    assert.strictEqual(pack[pack.length - 1], 0);
+  });
+
+  it('Should store tables & strings', function () {
+    const pack = create_binary_pack([ 'en-GB', 'ru-RU' ], data);
+    const ru = locale(pack, 1);
+    const singulars = pack.readUInt32LE(ru + 4);
+    const few = pack.readUInt32LE(ru + 8 + form_codes.few * 4);
+
+    assert.strictEqual(str(pack, pack.readUInt32LE(ru)), 'ru-RU');
+    assert.strictEqual(str(pack, pack.readUInt32LE(singulars)), 'Отмена');
+    assert.strictEqual(str(pack, pack.readUInt32LE(singulars + 4)), null);
+    assert.strictEqual(str(pack, pack.readUInt32LE(few)), '%d файла');
+    assert.strictEqual(pack.readUInt32LE(ru + 8 + form_codes.zero * 4), 0);
+    assert.strictEqual(pack.readUInt32LE(ru + 40), ru);
+  });
+
+  it('Should use built-in plural rules when possible', function () {
+    const pack = create_binary_pack([ 'en-GB', 'ru-RU', 'ja-JP' ], Object.assign({ 'ja-JP': data['ru-RU'] }, data));
+
+    // en - `one` for 1
+    assert.strictEqual(pack.readUInt32LE(locale(pack, 0) + 32), 0);
+    assert.strictEqual(pack[locale(pack, 0) + 38], 1);
+    // ru - bytecode
+    assert.notStrictEqual(pack.readUInt32LE(locale(pack, 1) + 32), 0);
+    // ja - `other` only
+    assert.strictEqual(pack.readUInt32LE(locale(pack, 2) + 32), 0);
+    assert.strictEqual(pack[locale(pack, 2) + 38], 0);
+  });
+
+  it('Keys hash should depend on keys', function () {
+    assert.notStrictEqual(keys_hash(data), keys_hash(Object.assign({}, data, { pluralKeys: [ 'file' ] })));
+    assert.notStrictEqual(keys_hash(data), keys_hash(Object.assign({}, data, {
+      singularKeys: [ 'cancel' ], pluralKeys: [ 'ok', 'files' ]
+    })));
+  });
+});
+
+
+describe('Plural bytecode', function () {
+
+  it('Should evaluate russian rules', function () {
+    const code = create_plural_bytecode('ru-RU');
+    const expected = { 0: 'many', 1: 'one', 2: 'few', 5: 'many', 11: 'many', 21: 'one', 22: 'few', 111: 'many' };
+
+    Object.entries(expected).forEach(([ n, form ]) => {
+      assert.strictEqual(eval_plural_bytecode(code, Number(n)), form_codes[form], `n = ${n}`);
+    });
+  });
+
+  it('Should evaluate arabic rules', function () {
+    const code = create_plural_bytecode('ar');
+    const expected = { 0: 'zero', 1: 'one', 2: 'two', 3: 'few', 11: 'many', 100: 'other', 103: 'few' };
+
+    Object.entries(expected).forEach(([ n, form ]) => {
+      assert.strictEqual(eval_plural_bytecode(code, Number(n)), form_codes[form], `n = ${n}`);
+    });
+  });
+
+  it('Should use absolute value', function () {
+    assert.strictEqual(eval_plural_bytecode(create_plural_bytecode('en'), -1), form_codes.one);
+  });
+});
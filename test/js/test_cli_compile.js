@@ -4,12 +4,25 @@
 const assert            = require('assert');
 const shell             = require('shelljs');
 const { join }          = require('path');
+const { readFileSync, writeFileSync, statSync, utimesSync } = require('fs');
 const { run }           = require('../../lib/cli');
 
 const fixtures_src_dir  = join(__dirname, 'fixtures/cli_compile');
 const fixtures_tmp_dir  = join(__dirname, 'fixtures/cli_compile.tmp');
 const demo_data_path    = join(__dirname, '../../support/template_data.yml');
 
+const long_en = 'A very long text about dogs. '.repeat(8);
+const long_ru = 'Очень длинный текст про собакенов. '.repeat(8);
+
+
+// Demo data is too small to pay for compression dictionary, add a long
+// repetitive phrase
+function write_compress_data(yml) {
+  writeFileSync(yml, readFileSync(demo_data_path, 'utf8')
+    .replace(/^en-GB:\n/m, `$&  s_long: "${long_en}"\n`)
+    .replace(/^ru-RU:\n/m, `$&  s_long: "${long_ru}"\n`));
+}
+
 
 describe('CLI compile', function () {
   beforeEach(function () {
@@ -40,6 +53,391 @@ describe('CLI compile', function () {
     assert.ok(shell.test('-f', join(fixtures_tmp_dir, 'out.h')));
   });
 
+  it('Should compile with linear lookup (.c/.h)', function () {
+    run([ 'compile', '-t', demo_data_path, '--linear-lookup', '-o', fixtures_tmp_dir ]);
+
+    assert.ok(/#define LV_I18N_LINEAR_LOOKUP 1/.test(readFileSync(join(fixtures_tmp_dir, 'lv_i18n.h'), 'utf8')));
+  });
+
+  it('Should compile with string pool (.c/.h)', function () {
+    run([ 'compile', '-t', demo_data_path, '--string-pool', '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+
+    assert.ok(/#define LV_I18N_STRING_POOL 1/.test(readFileSync(join(fixtures_tmp_dir, 'lv_i18n.h'), 'utf8')));
+    assert.ok(/lv_i18n_string_pool\[\]/.test(readFileSync(join(fixtures_tmp_dir, 'lv_i18n.c'), 'utf8')));
+  });
+
+  it('Should share plural functions of locales with the same rules', function () {
+    run([ 'compile', '-t', demo_data_path, '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+
+    const c = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.c'), 'utf8');
+
+    assert.ok(!/de_de_plural_fn/.test(c));
+    assert.ok(/de_de_lang = {[^}]+\.locale_plural_fn = en_gb_plural_fn/.test(c));
+  });
+
+  it('Should emit locale IDs and sorted locale index', function () {
+    run([ 'compile', '-t', demo_data_path, '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+
+    const h = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.h'), 'utf8');
+    const c = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.c'), 'utf8');
+
+    assert.ok(/LV_I18N_LOCALE_EN_GB = 0,/.test(h));
+    assert.ok(/LV_I18N_LOCALE_COUNT = 3/.test(h));
+    assert.ok(/#define LV_I18N_SINGULAR_COUNT 4/.test(h));
+    assert.ok(/#define LV_I18N_PLURAL_COUNT 1/.test(h));
+    assert.deepStrictEqual(
+      c.match(/lv_i18n_locale_order\[\] = {([^}]+)}/)[1].match(/\d+(?=,)/g),
+      [ '2', '0', '1' ] // de-de, en-gb, ru-ru
+    );
+  });
+
+  it('Should compile with plural tables (.c/.h)', function () {
+    run([ 'compile', '-t', demo_data_path, '--plural-table', '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+
+    const c = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.c'), 'utf8');
+
+    assert.ok(/#define LV_I18N_PLURAL_TABLE 1/.test(readFileSync(join(fixtures_tmp_dir, 'lv_i18n.h'), 'utf8')));
+    assert.ok(/de_de_lang = {[^}]+\.plural_rule = &en_gb_plural_rule/.test(c));
+    assert.ok(!/static uint8_t \w+_plural_fn/.test(c));
+  });
+
+  it('Should compile with format tokens (.c/.h)', function () {
+    run([ 'compile', '-t', demo_data_path, '--format-tokens', '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+
+    const c = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.c'), 'utf8');
+
+    assert.ok(/#define LV_I18N_FORMAT_TOKENS 1/.test(readFileSync(join(fixtures_tmp_dir, 'lv_i18n.h'), 'utf8')));
+    assert.ok(/lv_i18n_fmt_token_t lv_i18n_fmt_0\[\] = { \/\/ "Dogs of %s: %d"/.test(c));
+    assert.ok(/ru_ru_lang = {[^}]+\.singular_fmts = ru_ru_singular_fmts/.test(c));
+  });
+
+  it('Should compile with compressed strings (.c/.h)', function () {
+    const yml = join(fixtures_tmp_dir, 'data.yml');
+
+    write_compress_data(yml);
+    run([ 'compile', '-t', yml, '--compress', '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+
+    const h = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.h'), 'utf8');
+    const c = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.c'), 'utf8');
+
+    assert.ok(/#define LV_I18N_STRING_POOL 1/.test(h));
+    assert.ok(/#define LV_I18N_COMPRESS 1/.test(h));
+    assert.ok(new RegExp(`#define LV_I18N_DECODE_SIZE ${Buffer.byteLength(long_ru) + 1}\n`).test(c));
+    assert.ok(!/LV_I18N_DECODE_SIZE/.test(h));
+    assert.ok(/static const uint8_t lv_i18n_codebook\[256\]\[2\]/.test(c));
+    assert.ok(!/"s переведено\\0"/.test(c));
+  });
+
+  it('Should write plain pool if compression does not reduce size', function () {
+    const log = console.log;
+    let output = [];
+
+    /* eslint-disable no-console */
+    console.log = (...msg) => output.push(msg.join(' '));
+
+    try {
+      run([ 'compile', '-t', demo_data_path, '--compress', '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+    } finally {
+      console.log = log;
+    }
+
+    const h = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.h'), 'utf8');
+    const c = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.c'), 'utf8');
+
+    assert.ok(output.some(m => /Compression does not reduce size/.test(m)));
+    assert.ok(/#define LV_I18N_STRING_POOL 1/.test(h));
+    assert.ok(!/#define LV_I18N_COMPRESS/.test(h));
+    assert.ok(!/static const uint8_t lv_i18n_codebook/.test(c));
+    assert.ok(/"s переведено\\0"/.test(c));
+  });
+
+  it('Should not combine --screens with --compress', function () {
+    assert.throws(
+      () => {
+        run([ 'compile', '-t', demo_data_path, '-s', demo_data_path, '--screens', '--compress',
+          '-o', fixtures_tmp_dir ]);
+      },
+      /--screens option can not be used with --compress/
+    );
+  });
+
+  it('Should compile with string info (.c/.h)', function () {
+    run([ 'compile', '-t', demo_data_path, '--string-info', '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+
+    const h = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.h'), 'utf8');
+    const c = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.c'), 'utf8');
+
+    assert.ok(/#define LV_I18N_STRING_INFO 1/.test(h));
+    // "s переведено": 22 bytes, 12 code points
+    assert.ok(/\{ 22, 12, 0x81f307c9 \}, \/\/ \d+="s_translated"/.test(c));
+    assert.ok(/\.plural_info\[LV_I18N_PLURAL_TYPE_FEW\] = ru_ru_plural_info_few,/.test(c));
+  });
+
+  it('Should compile with locale diff (.c/.h)', function () {
+    run([ 'compile', '-t', demo_data_path, '--locale-diff', '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+
+    const h = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.h'), 'utf8');
+    const c = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.c'), 'utf8');
+
+    assert.ok(/#define LV_I18N_LOCALE_DIFF 1/.test(h));
+    assert.ok(/static const uint8_t lv_i18n_diff_0\[\] = \{ \/\/ en-GB <> ru-RU/.test(c));
+    // de-DE has no own translations
+    assert.ok(/lv_i18n_locale_diff\[\] = \{\n {4}lv_i18n_diff_0,\n {4}NULL,\n {4}lv_i18n_diff_0,\n\};/.test(c));
+  });
+
+  it('Should write glyphs of locales', function () {
+    run([ 'compile', '-t', demo_data_path, '--glyphs', join(fixtures_tmp_dir, 'glyphs.json'), '-l', 'en-GB' ]);
+
+    const glyphs = JSON.parse(readFileSync(join(fixtures_tmp_dir, 'glyphs.json'), 'utf8'));
+
+    assert.deepStrictEqual(Object.keys(glyphs.locales), [ 'en-GB', 'ru-RU', 'de-DE' ]);
+    assert.ok(/0x430-0x432/.test(glyphs.locales['ru-RU'].range));
+    assert.ok(!/0x4[0-9a-f]{2}/.test(glyphs.locales['en-GB'].range));
+    assert.ok(glyphs.all.count >= glyphs.locales['ru-RU'].count);
+  });
+
+  it('Should compile binary pack', function () {
+    run([ 'compile', '-t', demo_data_path, '--binary', join(fixtures_tmp_dir, 'lv_i18n.bin'), '-l', 'en-GB' ]);
+
+    assert.strictEqual(readFileSync(join(fixtures_tmp_dir, 'lv_i18n.bin')).subarray(0, 4).toString(), 'LVIP');
+  });
+
+  it('Should compile with resolved fallbacks (.c/.h)', function () {
+    run([ 'compile', '-t', demo_data_path, '--resolve-fallback', '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+
+    assert.ok(/#define LV_I18N_RESOLVED_FALLBACK 1/.test(readFileSync(join(fixtures_tmp_dir, 'lv_i18n.h'), 'utf8')));
+    assert.ok(/\.resolved = 1,/.test(readFileSync(join(fixtures_tmp_dir, 'lv_i18n.c'), 'utf8')));
+  });
+
+  it('Should compile locales to separate files (--split)', function () {
+    run([ 'compile', '-t', demo_data_path, '--split', '--string-pool', '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+
+    const c = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.c'), 'utf8');
+    const ru = readFileSync(join(fixtures_tmp_dir, 'lv_i18n_ru_ru.c'), 'utf8');
+
+    assert.ok(/LV_I18N_SPLIT_LOCALES\(X\) X\(en_gb\) X\(ru_ru\) X\(de_de\)/
+      .test(readFileSync(join(fixtures_tmp_dir, 'lv_i18n.h'), 'utf8')));
+    assert.ok(shell.test('-f', join(fixtures_tmp_dir, 'lv_i18n_en_gb.c')));
+    assert.ok(shell.test('-f', join(fixtures_tmp_dir, 'lv_i18n_de_de.c')));
+
+    // Core has no translations, each locale has own pool
+    assert.ok(!/s переведено/.test(c));
+    assert.ok(/lv_i18n_language_pack\[LV_I18N_LOCALE_COUNT \+ 1\];/.test(c));
+    assert.ok(/s переведено/.test(ru));
+    assert.ok(!/s translated/.test(ru));
+    assert.ok(/^const lv_i18n_lang_t lv_i18n_lang_ru_ru = {[^}]+\.keys_hash = LV_I18N_KEYS_HASH/m.test(ru));
+  });
+
+  it('Should fail on --split without output dir', function () {
+    assert.throws(
+      () => {
+        run([ 'compile', '-t', demo_data_path, '--split', '--raw', join(fixtures_tmp_dir, 'out.raw') ]);
+      },
+      /--split option requires output folder/
+    );
+  });
+
+  it('Should compile only phrases used in sources (-s, --sourceref)', function () {
+    const src = join(fixtures_tmp_dir, 'ui.c');
+    const ref = join(fixtures_tmp_dir, 'sourceref.json');
+
+    writeFileSync(src, 'lv_label_set_text(label, _("s_translated"));\n');
+    writeFileSync(ref, JSON.stringify([ { key: 'p_i_have_dogs', line: 1, plural: true, fileName: 'x.c' } ]));
+
+    run([ 'compile', '-t', demo_data_path, '-s', src, '--sourceref', ref, '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+
+    const c = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.c'), 'utf8');
+
+    assert.ok(/s переведено/.test(c));
+    assert.ok(/У меня %d собакен/.test(c));
+    assert.ok(!/english only/.test(c));
+    assert.ok(/#define LV_I18N_SINGULAR_COUNT 1\n/.test(readFileSync(join(fixtures_tmp_dir, 'lv_i18n.h'), 'utf8')));
+  });
+
+  it('Should report only locales with pruned strings', function () {
+    const src = join(fixtures_tmp_dir, 'ui.c');
+    const args = [ 'compile', '-t', demo_data_path, '-s', src, '-o', fixtures_tmp_dir, '-l', 'en-GB' ];
+    const log = console.log;
+    let output = [];
+
+    /* eslint-disable no-console */
+    console.log = (...msg) => output.push(msg.join(' '));
+
+    try {
+      // "s_en_only" is translated in en-GB only
+      writeFileSync(src, 'a = _("s_untranslated");\nb = _("s_translated");\n' +
+        'c = _("s_dogs_of");\nd = _p("p_i_have_dogs", n);\n');
+      run(args);
+      assert.ok(output.includes('Unused phrases removed: 1 of 5'));
+      assert.ok(output.some(m => /^ {2}en-GB: 1 strings/.test(m)));
+      assert.ok(!output.some(m => /ru-RU|de-DE/.test(m)));
+
+      output = [];
+      writeFileSync(src, readFileSync(src, 'utf8') + 'e = _("s_en_only");\n');
+      run(args);
+      assert.ok(output.includes('Unused phrases: none of 5, nothing pruned'));
+    } finally {
+      console.log = log;
+    }
+  });
+
+  it('Should fail on bad source references', function () {
+    const ref = join(fixtures_tmp_dir, 'sourceref.json');
+
+    writeFileSync(ref, '{ "s_translated": 1 }');
+
+    assert.throws(
+      () => {
+        run([ 'compile', '-t', demo_data_path, '--sourceref', ref, '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+      },
+      /Bad source references/
+    );
+  });
+
+  it('Should write phrase lists of source files (--screens)', function () {
+    const src = join(fixtures_tmp_dir, 'main-screen.c');
+
+    writeFileSync(src, [
+      '  _("s_translated"); _p("p_i_have_dogs", n);',
+      '  _("unknown"); _("s_en_only"); _("s_translated");'
+    ].join('\n'));
+    run([ 'compile', '-t', demo_data_path, '-s', src, '--screens', '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+
+    const h = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.h'), 'utf8');
+
+    assert.ok(h.includes(`#define LV_I18N_SCREEN_SINGULARS_main_screen { \\
+    1, /* "s_translated" */ \\
+    LV_I18N_ID_NOT_FOUND, /* "unknown" */ \\
+    0, /* "s_en_only" */ \\
+}
+#define LV_I18N_SCREEN_PLURALS_main_screen { \\
+    0, /* "p_i_have_dogs" */ \\
+}
+`));
+  });
+
+  it('Should fail on --screens without sources', function () {
+    assert.throws(
+      () => {
+        run([ 'compile', '-t', demo_data_path, '--screens', '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+      },
+      /--screens option requires source files/
+    );
+  });
+
+  it('Should place hot strings by profile (--profile)', function () {
+    const profile = join(fixtures_tmp_dir, 'profile.txt');
+
+    writeFileSync(profile, 'singular "s_translated": hits 5, fallbacks 0, misses 0, time 0\n');
+    run([ 'compile', '-t', demo_data_path, '--profile', profile, '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+
+    const c = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.c'), 'utf8');
+
+    assert.ok(/^static const char ru_ru_hot_strings\[\] LV_I18N_HOT_SECTION =\n[^;]*"s переведено\\0";/m.test(c));
+    assert.ok(/^static const char ru_ru_cold_strings\[\] LV_I18N_COLD_SECTION =\n/m.test(c));
+    assert.ok(/ru_ru_hot_strings \+ 1, \/\/ \d+="s_translated"/.test(c));
+    assert.ok(!/ru_ru_hot_strings \+ \d+, \/\/ \d+="s_dogs_of"/.test(c));
+  });
+
+  it('Should fail on --profile with string pool', function () {
+    assert.throws(
+      () => {
+        run([ 'compile', '-t', demo_data_path, '--profile', demo_data_path, '--string-pool', '-o', fixtures_tmp_dir ]);
+      },
+      /--profile option can not be used with --string-pool/
+    );
+  });
+
+  it('Should compile C++ front end (--cpp)', function () {
+    run([ 'compile', '-t', demo_data_path, '--cpp', '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+
+    const hpp = readFileSync(join(fixtures_tmp_dir, 'lv_i18n.hpp'), 'utf8');
+
+    assert.ok(/inline constexpr const char \* singular_keys\[\] = {\n[^}]*"s_translated",/.test(hpp));
+    assert.ok(/inline constexpr const char \* plural_keys\[\] = {\n {4}"p_i_have_dogs",\n {4}nullptr\n};/.test(hpp));
+    assert.ok(!/SAMPLE_START/.test(hpp));
+  });
+
+  it('Should fail on --cpp without output', function () {
+    assert.throws(
+      () => {
+        run([ 'compile', '-t', demo_data_path, '--cpp', '--binary', join(fixtures_tmp_dir, 'out.bin') ]);
+      },
+      /--cpp option requires output folder/
+    );
+  });
+
+  it('Should not touch unchanged outputs', function () {
+    const yml = join(fixtures_tmp_dir, 'data.yml');
+    const h = join(fixtures_tmp_dir, 'lv_i18n.h');
+    const c = join(fixtures_tmp_dir, 'lv_i18n.c');
+    const old = new Date(2000, 0, 1);
+
+    shell.cp(demo_data_path, yml);
+    run([ 'compile', '-t', yml, '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+    utimesSync(h, old, old);
+    utimesSync(c, old, old);
+
+    // Translation-only change, header has keys index only
+    writeFileSync(yml, readFileSync(yml, 'utf8').replace('s translated', 's translated 2'));
+    run([ 'compile', '-t', yml, '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+
+    assert.strictEqual(statSync(h).mtimeMs, old.getTime());
+    assert.notStrictEqual(statSync(c).mtimeMs, old.getTime());
+    assert.ok(/s translated 2/.test(readFileSync(c, 'utf8')));
+  });
+
+  it('Should keep header if the longest translation changes (--compress)', function () {
+    const yml = join(fixtures_tmp_dir, 'data.yml');
+    const h = join(fixtures_tmp_dir, 'lv_i18n.h');
+    const c = join(fixtures_tmp_dir, 'lv_i18n.c');
+
+    write_compress_data(yml);
+    run([ 'compile', '-t', yml, '--compress', '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+
+    const header = readFileSync(h);
+    const decode_size = /#define LV_I18N_DECODE_SIZE (\d+)/.exec(readFileSync(c, 'utf8'))[1];
+
+    // Longest translation grows, so decode buffer too
+    writeFileSync(yml, readFileSync(yml, 'utf8').replace(long_ru, `${long_ru}Ещё.`));
+    run([ 'compile', '-t', yml, '--compress', '-o', fixtures_tmp_dir, '-l', 'en-GB' ]);
+
+    assert.ok(readFileSync(h).equals(header));
+    assert.notStrictEqual(/#define LV_I18N_DECODE_SIZE (\d+)/.exec(readFileSync(c, 'utf8'))[1], decode_size);
+  });
+
+  it('Should skip compile if manifest is up to date', function () {
+    const manifest = join(fixtures_tmp_dir, 'manifest.json');
+    const c = join(fixtures_tmp_dir, 'lv_i18n.c');
+    const args = [ 'compile', '-t', demo_data_path, '-o', fixtures_tmp_dir, '-l', 'en-GB', '--manifest', manifest ];
+    const log = console.log;
+    let output = [];
+
+    /* eslint-disable no-console */
+    console.log = (...msg) => output.push(msg.join(' '));
+
+    try {
+      run(args);
+      assert.ok(!output.some(m => /not changed/.test(m)));
+
+      run(args);
+      assert.ok(output.some(m => /not changed/.test(m)));
+
+      // Damaged output is regenerated
+      writeFileSync(c, 'junk');
+      output = [];
+      run(args);
+      assert.ok(!output.some(m => /not changed/.test(m)));
+      assert.ok(/s_translated/.test(readFileSync(c, 'utf8')));
+
+      // Changed option is not skipped
+      run(args.concat([ '--optimize' ]));
+      assert.ok(/#define LV_I18N_OPTIMIZE 1/.test(readFileSync(join(fixtures_tmp_dir, 'lv_i18n.h'), 'utf8')));
+    } finally {
+      console.log = log;
+    }
+  });
+
   it('Should fail on missed files', function () {
     assert.throws(
       () => {
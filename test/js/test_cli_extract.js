@@ -92,6 +92,18 @@ describe('CLI extract', function () {
     );
   });
 
+  it('Should cache parsed sources, --cache', function () {
+    const cache = join(fixtures, 'cache.json');
+
+    run([ 'extract', '-s', join(fixtures, 'src_*.c'), '-t', join(fixtures, 'empty_*.yml'), '--cache', cache ]);
+    assert.deepStrictEqual(Object.keys(JSON.parse(readFileSync(cache)).files).length, 2);
+
+    // Second run takes keys from cache
+    run([ 'extract', '-s', join(fixtures, 'src_*.c'), '-t', join(fixtures, 'empty_*.yml'), '--cache', cache, '-j', '2' ]);
+    assert.deepStrictEqual(Object.keys(yaml.load(readFileSync(join(fixtures, 'empty_en-GB.yml')))['en-GB']),
+      [ 'text1', 'text2', 'text3' ]);
+  });
+
   it('Should add missed keys', function () {
     run([ 'extract', '-s', join(fixtures, 'src_1.c'), '-t', join(fixtures, 'partial_*.yml') ]);
 
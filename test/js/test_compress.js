@@ -0,0 +1,72 @@
+'use strict';
+
+
+const assert  = require('assert');
+
+const { create_codebook, create_compressed_pool, decode, MAX_DEPTH } = require('../../lib/compress');
+
+
+// Restore pool blob as C compiler would
+function blob(pool) {
+  return Buffer.concat([ Buffer.from([ 0 ]) ].concat(pool.entries.map(e => Buffer.from([ ...e.bytes, 0 ]))));
+}
+
+function read(pool, codebook, str) {
+  const buf = blob(pool);
+  const offset = pool.offset(str);
+
+  return decode(codebook.dict, [ ...buf.subarray(offset, buf.indexOf(0, offset)) ]).str;
+}
+
+
+describe('Compressed pool', function () {
+
+  const strings = [
+    'Cancel', 'Settings', 'Network settings', 'Display settings', 'I have %d dogs',
+    'Отмена', 'Настройки', 'Настройки сети', 'Настройки экрана', 'У меня %d собакенов',
+    '取消', '设置', '网络设置', '显示设置', '我有%d只狗'
+  ];
+
+  it('Should restore all strings', function () {
+    const codebook = create_codebook(strings);
+    const pool = create_compressed_pool(strings, codebook);
+
+    strings.forEach(str => assert.strictEqual(read(pool, codebook, str), str));
+    assert.ok(pool.size < blob({ entries: strings.map(str => ({ bytes: Buffer.from(str) })) }).length);
+  });
+
+  it('Should encode strings not used for training', function () {
+    const codebook = create_codebook(strings);
+    const pool = create_compressed_pool([ 'Sound settings', 'Настройки звука' ], codebook);
+
+    assert.strictEqual(read(pool, codebook, 'Sound settings'), 'Sound settings');
+    assert.strictEqual(read(pool, codebook, 'Настройки звука'), 'Настройки звука');
+  });
+
+  it('Should reserve zero offset for NULL and store equal strings once', function () {
+    const codebook = create_codebook(strings);
+    const pool = create_compressed_pool([ null, 'Cancel', '', 'Cancel' ], codebook);
+
+    assert.strictEqual(pool.offset(null), 0);
+    assert.strictEqual(pool.offset(''), 0);
+    assert.strictEqual(pool.offset('Cancel'), 1);
+    assert.strictEqual(pool.entries.length, 1);
+  });
+
+  it('Should use only bytes, free in all strings, as codes', function () {
+    const codebook = create_codebook(strings);
+    const used = new Set(strings.flatMap(str => [ ...Buffer.from(str) ]));
+
+    codebook.merges.forEach(([ , , code ]) => assert.ok(!used.has(code)));
+  });
+
+  it('Should limit nesting of pairs', function () {
+    // Pairs of pairs of ... for long repeated strings
+    const codebook = create_codebook([ 'a'.repeat(100000), 'a'.repeat(99999) ]);
+    const [ a, b ] = [ 0, 1 ].map(i => c => codebook.dict[c * 2 + i]);
+    const depth = c => (a(c) ? 1 + Math.max(depth(a(c)), depth(b(c))) : 0);
+
+    codebook.merges.forEach(([ , , code ]) => assert.ok(depth(code) <= MAX_DEPTH));
+    assert.strictEqual(decode(codebook.dict, [ ...codebook.encode('a'.repeat(99999)) ]).str, 'a'.repeat(99999));
+  });
+});
@@ -0,0 +1,96 @@
+'use strict';
+
+
+const assert  = require('assert');
+
+const { parse_format, create_format_tables, arg_types } = require('../../lib/format');
+
+
+// Restore format string from tokens, with argument numbers
+function restore(str, tokens) {
+  const b = Buffer.from(str);
+
+  return tokens.map(t => {
+    const text = b.subarray(t.start, t.start + t.len).toString();
+    return t.arg ? `{${t.arg}:${text}}` : text;
+  }).join('');
+}
+
+function create_data(strings) {
+  const data = { singularKeys: Object.keys(strings[0]), pluralKeys: [] };
+
+  strings.forEach((singular, i) => { data[`l${i}`] = { singular, plural: {} }; });
+
+  return data;
+}
+
+
+describe('Format', function () {
+
+  it('Should split literals and specs', function () {
+    const str = 'Total: %d, %-5.2f%% of %s';
+
+    assert.strictEqual(restore(str, parse_format(str)), 'Total: {1:d}, {2:-5.2f}% of {3:s}');
+  });
+
+  it('Should parse positional arguments', function () {
+    const str = '%2$s has %1$lu items';
+    const tokens = parse_format(str);
+
+    assert.strictEqual(restore(str, tokens), '{2:s} has {1:lu} items');
+    assert.deepStrictEqual(tokens.filter(t => t.arg).map(t => t.type), [ arg_types.str, arg_types.ulong ]);
+  });
+
+  it('Should detect argument types', function () {
+    const types = parse_format('%c %hhd %x %ld %llu %zu %e %p').filter(t => t.arg).map(t => t.type);
+
+    assert.deepStrictEqual(types, [
+      arg_types.int, arg_types.int, arg_types.uint, arg_types.long,
+      arg_types.ullong, arg_types.size, arg_types.double, arg_types.ptr
+    ]);
+  });
+
+  it('Should keep invalid specs as text', function () {
+    const str = '100% %q %10$d %';
+
+    assert.strictEqual(restore(str, parse_format(str)), str);
+    assert.ok(parse_format(str).every(t => !t.arg));
+  });
+
+  it('Should count offsets in UTF-8 bytes', function () {
+    const str = 'Собак: %d';
+
+    assert.strictEqual(restore(str, parse_format(str)), 'Собак: {1:d}');
+  });
+
+  it('Should share token lists of equal strings', function () {
+    const tables = create_format_tables([ 'l0', 'l1' ], create_data([
+      { a: '%d items', b: 'plain', c: null },
+      { a: '%d items', b: '%s', c: 'text' }
+    ]));
+
+    assert.strictEqual(tables.lists.length, 2);
+    assert.strictEqual(tables.name('%d items'), tables.lists[0].name);
+    assert.strictEqual(tables.name('plain'), 'lv_i18n_fmt_plain');
+    assert.strictEqual(tables.name(null), 'NULL');
+  });
+
+  it('Should fill argument gaps from other locales', function () {
+    const tables = create_format_tables([ 'l0', 'l1' ], create_data([
+      { a: '%s: %d' },
+      { a: '%2$d' }
+    ]));
+
+    assert.deepStrictEqual(
+      tables.lists[1].tokens[0],
+      { start: 0, len: 0, arg: 1, type: arg_types.str }
+    );
+  });
+
+  it('Should fail on different argument types', function () {
+    assert.throws(
+      () => create_format_tables([ 'l0', 'l1' ], create_data([ { a: '%s: %d' }, { a: '%2$s: %1$s' } ])),
+      /Format argument 2 of "a" has different type in l1/
+    );
+  });
+});
@@ -0,0 +1,61 @@
+'use strict';
+
+
+const assert  = require('assert');
+
+const { create_glyphs, to_ranges } = require('../../lib/glyphs');
+
+
+function create_data(translations) {
+  const data = { singularKeys: [], pluralKeys: [] };
+
+  Object.entries(translations).forEach(([ l, { singular = {}, plural = {} } ]) => {
+    data[l] = { singular, plural };
+    Object.keys(singular).forEach(k => { if (!data.singularKeys.includes(k)) data.singularKeys.push(k); });
+    Object.values(plural).forEach(form => Object.keys(form).forEach(k => {
+      if (!data.pluralKeys.includes(k)) data.pluralKeys.push(k);
+    }));
+  });
+
+  return data;
+}
+
+const cp = str => new Set([ ...str ].map(ch => ch.codePointAt(0)));
+
+
+describe('Glyphs', function () {
+
+  it('Should merge adjacent code points to ranges', function () {
+    assert.strictEqual(to_ranges(new Set([ 0x62, 0x20, 0x61, 0x63, 0x401, 0x65 ])), '0x20,0x61-0x63,0x65,0x401');
+    assert.strictEqual(to_ranges(new Set()), '');
+  });
+
+  it('Should collect glyphs per locale and combined', function () {
+    const data = create_data({
+      'en-GB': { singular: { ok: 'OK', cancel: 'Cancel' } },
+      'ru-RU': { singular: { ok: 'Ок', cancel: 'Отмена' } }
+    });
+    const glyphs = create_glyphs([ 'en-GB', 'ru-RU' ], data);
+
+    assert.strictEqual(glyphs.locales['en-GB'].range, to_ranges(cp('OKCancel')));
+    assert.strictEqual(glyphs.locales['ru-RU'].range, to_ranges(cp('ОкОтмена')));
+    assert.strictEqual(glyphs.all.range, to_ranges(cp('OKCancelОкОтмена')));
+    assert.strictEqual(glyphs.all.count, cp('OKCancelОкОтмена').size);
+  });
+
+  it('Should add glyphs of base locale fallbacks', function () {
+    const data = create_data({
+      'en-GB': { singular: { ok: 'OK', cancel: 'Cancel' }, plural: { one: { dogs: 'dog' }, other: { dogs: 'dogs' } } },
+      'ru-RU': { singular: { ok: 'Ок' }, plural: { one: { dogs: 'пёс' }, few: { dogs: 'пса' } } }
+    });
+    const glyphs = create_glyphs([ 'en-GB', 'ru-RU' ], data);
+
+    assert.strictEqual(glyphs.locales['ru-RU'].range, to_ranges(cp('ОкCancelпёспсаdogdogs')));
+  });
+
+  it('Should replace format specs with printed glyphs', function () {
+    const data = create_data({ 'en-GB': { singular: { a: '%2$s: %1$d%%', b: 'x\n%u' } } });
+
+    assert.strictEqual(create_glyphs([ 'en-GB' ], data).locales['en-GB'].range, to_ranges(cp(': -0123456789%x')));
+  });
+});
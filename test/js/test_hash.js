@@ -0,0 +1,79 @@
+'use strict';
+
+
+const assert  = require('assert');
+
+const { fnv1a, mix, create_perfect_hash, literal_hash, create_literal_perfect_hash } = require('../../lib/hash');
+
+
+function lookup(ph, keys, key) {
+  const h = fnv1a(key, ph.seed);
+  const d = ph.disp[mix(h, 0) % ph.disp.length];
+  const slot = d < 0 ? -d - 1 : mix(h, d) % keys.length;
+  const idx = ph.slots[slot];
+
+  return keys[idx] === key ? idx : -1;
+}
+
+
+describe('Hash', function () {
+
+  it('FNV-1a should match reference values', function () {
+    assert.strictEqual(fnv1a(''), 0x811c9dc5);
+    assert.strictEqual(fnv1a('a'), 0xe40c292c);
+    assert.strictEqual(fnv1a('foobar'), 0xbf9cf968);
+  });
+
+  it('FNV-1a should hash UTF-8 bytes', function () {
+    // 'ы' = 0xD1 0x8B
+    assert.strictEqual(fnv1a('ы'), 0x44c0b6d5);
+  });
+
+  it('Should create dummy tables for empty keys list', function () {
+    const ph = create_perfect_hash([]);
+
+    assert.deepStrictEqual(ph.disp, [ 0 ]);
+    assert.deepStrictEqual(ph.slots, [ 0 ]);
+  });
+
+  it('Should reject more keys than 16-bit phrase IDs can address', function () {
+    const keys = Array.from({ length: 0x10000 }, (_, i) => `k${i}`);
+
+    assert.throws(() => create_perfect_hash(keys), /Too many phrases/);
+    assert.throws(() => create_literal_perfect_hash([ [], keys ]), /Too many phrases/);
+  });
+
+  it('Should create minimal perfect hash', function () {
+    [ 1, 2, 3, 10, 100, 5000 ].forEach(n => {
+      const keys = Array.from({ length: n }, (_, i) => `key ${i} текст`);
+      const ph = create_perfect_hash(keys);
+
+      assert.strictEqual(ph.slots.length, n);
+      assert.deepStrictEqual([ ...ph.slots ].sort((a, b) => a - b), keys.map((_, i) => i));
+
+      keys.forEach((k, i) => assert.strictEqual(lookup(ph, keys, k), i));
+      assert.strictEqual(lookup(ph, keys, 'not existing'), -1);
+    });
+  });
+
+  it('Should create literal perfect hash', function () {
+    const singulars = Array.from({ length: 1000 }, (_, i) => `screen.label_${i}`);
+    const plurals = [ 'dogs', 'собаки' ];
+    const { weights, sets } = create_literal_perfect_hash([ singulars, plurals, [] ]);
+
+    [ singulars, plurals ].forEach((keys, n) => {
+      const { hashes, disp, slots } = sets[n];
+
+      keys.forEach((k, i) => {
+        const h = literal_hash(k, weights);
+        const d = disp[mix(h, 0) % disp.length];
+        const slot = d < 0 ? -d - 1 : mix(h, d) % keys.length;
+
+        assert.strictEqual(hashes[i], h);
+        assert.strictEqual(slots[slot], i);
+      });
+    });
+
+    assert.deepStrictEqual(sets[2].slots, [ 0 ]);
+  });
+});
@@ -0,0 +1,65 @@
+'use strict';
+
+
+const assert  = require('assert');
+
+const { create_locale_diff, pair_index } = require('../../lib/locale_diff');
+
+
+// Keys of bitmap, singulars first
+function changed(diff, data, name) {
+  const bitmap = diff.bitmaps.find(b => b.name === name);
+  const keys = data.singularKeys.concat(data.pluralKeys);
+
+  if (!bitmap) return [];
+
+  // eslint-disable-next-line no-bitwise
+  return keys.filter((k, i) => bitmap.bytes[Math.floor(i / 8)] & (1 << (i % 8)));
+}
+
+
+describe('Locale diff', function () {
+
+  const data = {
+    singularKeys: [ 'color', 'ok', 'only_base', 'untranslated' ],
+    pluralKeys: [ 'items', 'files' ],
+    'en-GB': {
+      singular: { color: 'Colour', ok: 'OK', only_base: 'Base' },
+      plural: { one: { items: '%d item', files: '%d file' }, other: { items: '%d items', files: '%d files' } }
+    },
+    'en-US': {
+      singular: { color: 'Color', ok: 'OK' },
+      plural: { one: { items: '%d item' }, other: { items: '%d items' } }
+    },
+    'ru-RU': {
+      singular: { color: 'Цвет', ok: 'OK' },
+      plural: { one: { items: '%d штука' }, few: { items: '%d штуки' }, many: { items: '%d штук' } }
+    },
+    'de-DE': { singular: {}, plural: {} }
+  };
+  const locales = [ 'en-GB', 'en-US', 'ru-RU', 'de-DE' ];
+
+  it('Should mark only texts, different after fallbacks', function () {
+    const diff = create_locale_diff(locales, data);
+
+    assert.deepStrictEqual(changed(diff, data, diff.pairs[pair_index(0, 1, 4)]), [ 'color' ]);
+    assert.deepStrictEqual(changed(diff, data, diff.pairs[pair_index(1, 2, 4)]), [ 'color', 'items' ]);
+    assert.deepStrictEqual(changed(diff, data, diff.pairs[pair_index(0, 2, 4)]), [ 'color', 'items' ]);
+  });
+
+  it('Should skip pairs without changes', function () {
+    const diff = create_locale_diff(locales, data);
+
+    // de-DE has nothing own, all is taken from base locale
+    assert.strictEqual(diff.pairs[pair_index(0, 3, 4)], null);
+    assert.strictEqual(diff.pairs.length, 6);
+  });
+
+  it('Should share equal bitmaps', function () {
+    const diff = create_locale_diff(locales, data);
+
+    // en-GB <> ru-RU and ru-RU <> de-DE
+    assert.strictEqual(diff.pairs[pair_index(0, 2, 4)], diff.pairs[pair_index(2, 3, 4)]);
+    assert.strictEqual(new Set(diff.pairs.filter(Boolean)).size, diff.bitmaps.length);
+  });
+});
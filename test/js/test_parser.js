@@ -18,6 +18,7 @@ describe('Parser', function () {
         const char* my_text = _("My text");
         int i;
         const char* my_text2 =  _("My text2");
+        lv_label_set_text(label, _i("My text3"));
       `),
       [
         {
@@ -29,6 +30,11 @@ describe('Parser', function () {
           key: 'My text2',
           line: 4,
           plural: false
+        },
+        {
+          key: 'My text3',
+          line: 5,
+          plural: false
         }
       ]
     );
@@ -123,6 +129,135 @@ describe('Parser', function () {
   });
 
 
+  it('Should find context versions', function () {
+    assert.deepStrictEqual(
+      parse(`
+        const char* s1 = _c(&ui_ctx, "singular 1");
+        const char* p1 = _cp(ctx->i18n, "plural 1", number);
+      `),
+      [
+        {
+          key: 'singular 1',
+          line: 2,
+          plural: false
+        },
+        {
+          key: 'plural 1',
+          line: 3,
+          plural: true
+        }
+      ]
+    );
+  });
+
+
+  it('Should find format functions', function () {
+    assert.deepStrictEqual(
+      parse(`
+        lv_i18n_format(buf, sizeof(buf), "singular 1", name, count);
+        n = lv_i18n_format_plural(buf, 20, "plural 1", count, count);
+        lv_i18n_ctx_format(&ctx, ui->buf, BUF_SIZE, "singular 2");
+        lv_i18n_ctx_format_plural(ctx, buf, sizeof(buf), "plural 2", count);
+      `),
+      [
+        {
+          key: 'singular 1',
+          line: 2,
+          plural: false
+        },
+        {
+          key: 'plural 1',
+          line: 3,
+          plural: true
+        },
+        {
+          key: 'singular 2',
+          line: 4,
+          plural: false
+        },
+        {
+          key: 'plural 2',
+          line: 5,
+          plural: true
+        }
+      ]
+    );
+  });
+
+
+  it('Should find nested calls of different kinds', function () {
+    assert.deepStrictEqual(
+      parse(`
+        printf(_p("plural 1", n),_("singular 1"));
+      `),
+      [
+        {
+          key: 'plural 1',
+          line: 2,
+          plural: true
+        },
+        {
+          key: 'singular 1',
+          line: 2,
+          plural: false
+        }
+      ]
+    );
+  });
+
+
+  it('Should find C++ front end calls', function () {
+    assert.deepStrictEqual(
+      parse(`
+        label.set_text(LV_I18N_TR("singular 1"));
+        label.set_text(LV_I18N_TRP("plural 1", n));
+        auto s2 = lv_i18n::tr<"singular 2">();
+        auto p2 = lv_i18n::trp<"plural 2">(&ctx, n);
+        auto s3 = "singular \\"3\\""_tr;
+        auto s4 = "not a phrase"_trim;
+      `).map(({ key, plural }) => ({ key, plural })),
+      [
+        { key: 'singular 1', plural: false },
+        { key: 'plural 1', plural: true },
+        { key: 'singular 2', plural: false },
+        { key: 'plural 2', plural: true },
+        { key: 'singular "3"', plural: false }
+      ]
+    );
+  });
+
+
+  it('Should scan big sources in linear time', function () {
+    function source(calls) {
+      let src = '';
+
+      for (let i = 0; i < calls; i++) {
+        src += `    lv_label_set_text(label_${i}, _("screen.label_${i}"));\n`;
+        src += `    lv_label_set_text(count_${i}, _p("screen.items_${i}", n));\n\n`;
+      }
+
+      return src;
+    }
+
+    function measure(calls) {
+      const text = source(calls);
+      const start = process.hrtime.bigint();
+
+      assert.strictEqual(parse(text).length, calls * 2);
+
+      return Number(process.hrtime.bigint() - start);
+    }
+
+    measure(2000); // warm up
+
+    // 8x bigger source. Quadratic scan would be ~64x slower.
+    const small = Math.min(measure(5000), measure(5000));
+    const big = measure(40000);
+
+    assert.ok(big / small < 24, `8x source took ${(big / small).toFixed(1)}x time`);
+  });
+
+
   describe('unescape_c', function () {
     const test_file = join(__dirname, 'fixtures/c_escapes.yml');
     let tests = yaml.load(readFileSync(test_file));
@@ -0,0 +1,60 @@
+'use strict';
+
+
+const assert  = require('assert');
+
+const { parse_profile, create_placement } = require('../../lib/profile');
+
+
+describe('Profile', function () {
+
+  it('Should take used phrases from stats dump', function () {
+    const profile = parse_profile([
+      'locale "en-GB": hits 10, fallbacks 2, misses 1, time 5',
+      'singular "title": hits 7, fallbacks 0, misses 0, time 3',
+      'singular "only_base": hits 0, fallbacks 2, misses 0, time 1',
+      'singular "untranslated": hits 0, fallbacks 0, misses 1, time 1',
+      'plural "items": hits 3, fallbacks 0, misses 0, time 1',
+      'singular "very long phrase, truncated by dump buff',
+      'unknown phrases: 4'
+    ].join('\n'));
+
+    assert.deepStrictEqual([ ...profile.singular ], [ 'title', 'only_base' ]);
+    assert.deepStrictEqual([ ...profile.plural ], [ 'items' ]);
+    assert.strictEqual(profile.skipped, 1);
+  });
+
+  it('Should take list of phrases', function () {
+    const profile = parse_profile('title\r\nitems\n\n');
+
+    assert.deepStrictEqual([ ...profile.singular ], [ 'title', 'items' ]);
+    assert.deepStrictEqual([ ...profile.plural ], [ 'title', 'items' ]);
+  });
+
+  it('Should split strings of each locale to hot & cold pools', function () {
+    const data = {
+      singularKeys: [ 'ok', 'title', 'help' ],
+      pluralKeys: [ 'items' ],
+      'en-GB': {
+        singular: { ok: 'OK', title: 'Menu', help: 'OK' },
+        plural: { one: { items: '%d item' }, other: { items: '%d items' } }
+      },
+      'de-DE': {
+        singular: { title: 'Menü', help: 'Hilfe' },
+        plural: {}
+      }
+    };
+    const placement = create_placement([ 'en-GB', 'de-DE' ], data, parse_profile('title\nok\n'));
+    const en = placement.locales['en-GB'];
+    const de = placement.locales['de-DE'];
+
+    assert.deepStrictEqual([ ...placement.hot.singular ], [ 'ok', 'title' ]);
+    assert.deepStrictEqual([ ...placement.hot.plural ], []);
+
+    // "OK" of cold phrase is shared with hot one
+    assert.deepStrictEqual(en.hot.entries.map(e => e.str), [ 'OK', 'Menu' ]);
+    assert.deepStrictEqual(en.cold.entries.map(e => e.str), [ '%d item', '%d items' ]);
+    assert.deepStrictEqual(de.hot.entries.map(e => e.str), [ 'Menü' ]);
+    assert.deepStrictEqual(de.cold.entries.map(e => e.str), [ 'Hilfe' ]);
+  });
+});
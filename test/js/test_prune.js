@@ -0,0 +1,49 @@
+'use strict';
+
+
+const assert  = require('assert');
+
+const { prune_keys } = require('../../lib/prune');
+
+
+describe('Prune', function () {
+
+  function create_data() {
+    return {
+      singularKeys: [ 'legacy', 'title' ],
+      pluralKeys: [ 'files', 'items' ],
+      'en-GB': {
+        singular: { legacy: 'Old', title: 'Menu' },
+        plural: { one: { files: '%d file', items: '%d item' }, other: { files: '%d files', items: '%d items' } }
+      },
+      'ru-RU': {
+        singular: { legacy: 'Старое' },
+        plural: { one: { files: '%d файл' }, few: { files: '%d файла' } }
+      }
+    };
+  }
+
+  it('Should keep only used phrases', function () {
+    const data = create_data();
+
+    prune_keys([ 'en-GB', 'ru-RU' ], data, new Set([ 'title', 'items', 'not_translated' ]));
+
+    assert.deepStrictEqual(data.singularKeys, [ 'title' ]);
+    assert.deepStrictEqual(data.pluralKeys, [ 'items' ]);
+    assert.deepStrictEqual(data['en-GB'].singular, { title: 'Menu' });
+    assert.deepStrictEqual(data['en-GB'].plural, { one: { items: '%d item' }, other: { items: '%d items' } });
+
+    // Forms without phrases are dropped
+    assert.deepStrictEqual(data['ru-RU'], { singular: {}, plural: {} });
+  });
+
+  it('Should report removed strings per locale', function () {
+    const report = prune_keys([ 'en-GB', 'ru-RU' ], create_data(), new Set([ 'title', 'items' ]));
+
+    assert.deepStrictEqual(report.keys, [ 'legacy', 'files' ]);
+    assert.deepStrictEqual(report.locales, {
+      'en-GB': { strings: 3, bytes: 4 + 8 + 9 },
+      'ru-RU': { strings: 3, bytes: 13 + 12 + 14 }
+    });
+  });
+});
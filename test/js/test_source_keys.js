@@ -2,9 +2,14 @@
 
 
 const assert      = require('assert');
+const shell       = require('shelljs');
 const { join }    = require('path');
+const { readFileSync, writeFileSync, utimesSync } = require('fs');
 
 const SourceKeys  = require('../../lib/source_keys');
+const { parseFiles } = require('../../lib/source_worker');
+
+const tmp_dir     = join(__dirname, 'fixtures/source_keys.tmp');
 
 
 describe('SourceKeys', function () {
@@ -40,4 +45,72 @@ const char* plural = _p("the same text", 5);
     );
   });
 
+  describe('loadFiles', function () {
+    beforeEach(function () {
+      shell.rm('-rf', tmp_dir);
+      shell.mkdir('-p', tmp_dir);
+    });
+
+    afterEach(function () {
+      shell.rm('-rf', tmp_dir);
+    });
+
+    it('Should parse files in parallel', function () {
+      for (let i = 0; i < 500; i++) {
+        writeFileSync(join(tmp_dir, `src_${i}.c`), `
+a = _("text ${i}");
+b = _p("items ${i % 10}", n);
+`);
+      }
+
+      let serial = new SourceKeys();
+      let parallel = new SourceKeys();
+
+      serial.loadFiles([ join(tmp_dir, '*.c') ], { jobs: 1 });
+      parallel.loadFiles([ join(tmp_dir, '*.c') ], { jobs: 2 });
+
+      assert.equal(parallel.filesCount, 500);
+      assert.deepStrictEqual(parallel.keys, serial.keys);
+    });
+
+    it('Should report errors of parallel jobs', function () {
+      let files = [];
+
+      for (let i = 0; i < 500; i++) {
+        writeFileSync(join(tmp_dir, `src_${i}.c`), `a = _("text ${i}");\n`);
+        files.push({ name: join(tmp_dir, `src_${i}.c`) });
+      }
+
+      files[400] = { name: join(tmp_dir, 'missed.c') };
+
+      assert.throws(() => parseFiles(files, 2), /missed\.c/);
+    });
+
+    it('Should use cache for unchanged files', function () {
+      const cache = join(tmp_dir, 'cache.json');
+      const src = join(tmp_dir, 'src.c');
+      const load = () => {
+        let sk = new SourceKeys();
+        sk.loadFiles([ join(tmp_dir, '*.c') ], { cache });
+        return sk.keys.map(k => k.key);
+      };
+
+      writeFileSync(src, 'a = _("text");\n');
+      assert.deepStrictEqual(load(), [ 'text' ]);
+
+      // Patch cache, to see if it is used
+      let data = JSON.parse(readFileSync(cache, 'utf8'));
+      data.keys = [ 'cached text' ];
+      writeFileSync(cache, JSON.stringify(data));
+
+      assert.deepStrictEqual(load(), [ 'cached text' ]);
+
+      // Touched, but not changed
+      utimesSync(src, new Date(), new Date(Date.now() + 10000));
+      assert.deepStrictEqual(load(), [ 'cached text' ]);
+
+      writeFileSync(src, 'a = _("new text");\n');
+      assert.deepStrictEqual(load(), [ 'new text' ]);
+    });
+  });
 });
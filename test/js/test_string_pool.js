@@ -0,0 +1,52 @@
+'use strict';
+
+
+const assert  = require('assert');
+
+const { create_string_pool } = require('../../lib/string_pool');
+
+
+// Restore pool blob as C compiler would
+function blob(pool) {
+  return Buffer.concat([ Buffer.from([ 0 ]) ].concat(pool.entries.map(e => Buffer.from(e.str + '\0'))));
+}
+
+function read(pool, str) {
+  const buf = blob(pool);
+  const offset = pool.offset(str);
+
+  return buf.subarray(offset, buf.indexOf(0, offset)).toString();
+}
+
+
+describe('String pool', function () {
+
+  it('Should reserve zero offset for NULL', function () {
+    const pool = create_string_pool([ null, 'abc', '' ]);
+
+    assert.strictEqual(pool.offset(null), 0);
+    assert.strictEqual(pool.offset(''), 0);
+    assert.strictEqual(pool.offset('abc'), 1);
+    assert.strictEqual(pool.size, 5);
+  });
+
+  it('Should store equal strings once', function () {
+    const pool = create_string_pool([ 'Cancel', 'OK', 'Cancel', 'OK' ]);
+
+    assert.strictEqual(pool.entries.length, 2);
+    assert.strictEqual(pool.size, blob(pool).length);
+  });
+
+  it('Should merge suffixes', function () {
+    const strings = [ 'el', 'Cancel', 'Отмена', 'мена', 'a', 'Cancel', 'ncel' ];
+    const pool = create_string_pool(strings);
+
+    assert.deepStrictEqual(pool.entries.map(e => e.str), [ 'Cancel', 'Отмена', 'a' ]);
+    strings.forEach(str => assert.strictEqual(read(pool, str), str));
+  });
+
+  it('Should select offset type by pool size', function () {
+    assert.strictEqual(create_string_pool([ 'a'.repeat(0xFFFD) ]).offset_type, 'uint16_t');
+    assert.strictEqual(create_string_pool([ 'a'.repeat(0xFFFE) ]).offset_type, 'uint32_t');
+  });
+});